@@ -0,0 +1,55 @@
+#version 450
+
+// Cell outline overlay: draws label boundaries and fills selected cells
+// Labels come from ct::SegmentationMask::decodeTile (R32_UINT, 0 = background)
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+layout(binding = 0) uniform usampler2D labelTile;
+
+// One bit per label, packed by ct::SegmentationMask::buildSelectionBits
+layout(std430, binding = 1) readonly buffer Selection {
+    uint selectedBits[];
+};
+
+layout(push_constant) uniform PushConstants {
+    vec4 tileRect;
+    vec4 outlineColor;
+    vec4 selectedColor;
+} pushConstants;
+
+uint labelAt(ivec2 texel, ivec2 size) {
+    // Clamping at the tile border avoids false edges between tiles
+    return texelFetch(labelTile, clamp(texel, ivec2(0), size - 1), 0).r;
+}
+
+bool isSelected(uint label) {
+    uint word = label >> 5;
+    return word < uint(selectedBits.length()) && (selectedBits[word] & (1u << (label & 31u))) != 0u;
+}
+
+void main() {
+    ivec2 size = textureSize(labelTile, 0);
+    ivec2 texel = min(ivec2(fragTexCoord * vec2(size)), size - 1);
+
+    uint label = labelAt(texel, size);
+    if (label == 0u) {
+        discard;
+    }
+
+    uvec4 neighbors = uvec4(labelAt(texel + ivec2(-1, 0), size), labelAt(texel + ivec2(1, 0), size),
+                            labelAt(texel + ivec2(0, -1), size), labelAt(texel + ivec2(0, 1), size));
+    bool edge = any(notEqual(neighbors, uvec4(label)));
+    bool selected = isSelected(label);
+
+    if (selected) {
+        // Solid outline, translucent fill
+        outColor = edge ? vec4(pushConstants.selectedColor.rgb, 1.0) : pushConstants.selectedColor;
+    } else if (edge) {
+        outColor = pushConstants.outlineColor;
+    } else {
+        discard;
+    }
+}
@@ -0,0 +1,19 @@
+#version 450
+
+// Draws one mask tile as a quad; no vertex buffer (4 vertices, triangle strip)
+
+layout(location = 0) out vec2 fragTexCoord;
+
+// Push constants shared with cell_outline.frag
+layout(push_constant) uniform PushConstants {
+    vec4 tileRect;          // Tile corners in clip space: xy = min, zw = max
+    vec4 outlineColor;
+    vec4 selectedColor;
+} pushConstants;
+
+void main() {
+    vec2 corner = vec2(gl_VertexIndex & 1, (gl_VertexIndex >> 1) & 1);
+
+    gl_Position = vec4(mix(pushConstants.tileRect.xy, pushConstants.tileRect.zw, corner), 0.0, 1.0);
+    fragTexCoord = corner;
+}
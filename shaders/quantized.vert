@@ -0,0 +1,36 @@
+#version 450
+
+// Quantized vertex attributes (see ct::QuantizedVertex)
+layout(location = 0) in vec4 inPosition;    // UNORM16, normalized to mesh bounds
+layout(location = 1) in vec2 inNormal;      // Octahedral SNORM16
+layout(location = 2) in vec2 inTexCoord;    // UNORM16, normalized to UV bounds
+layout(location = 3) in vec4 inColor;       // UNORM8 RGBA
+
+// Output to fragment shader (locations 0-1 match basic.frag)
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec3 fragNormal;
+
+// Push constants: MVP followed by ct::QuantizationParams
+layout(push_constant) uniform PushConstants {
+    mat4 mvp;
+    vec4 positionOffset;
+    vec4 positionScale;
+    vec4 uvOffsetScale;
+} pushConstants;
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+void main() {
+    vec3 position = pushConstants.positionOffset.xyz + inPosition.xyz * pushConstants.positionScale.xyz;
+
+    gl_Position = pushConstants.mvp * vec4(position, 1.0);
+    fragColor = inColor.rgb;
+    fragTexCoord = pushConstants.uvOffsetScale.xy + inTexCoord * pushConstants.uvOffsetScale.zw;
+    fragNormal = decodeOctahedral(inNormal);
+}
@@ -0,0 +1,487 @@
+#include "asset_pipeline/asset_database.h"
+#include "core/hash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <system_error>
+
+namespace ct {
+
+namespace {
+
+constexpr const char* kDatabaseHeader = "# Cellular Threshold asset database v1";
+
+/// Hash a file's contents in fixed-size chunks
+bool hashFile(const std::filesystem::path& path, uint64_t& outHash) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    Hasher64 hasher;
+    std::vector<char> chunk(1 << 20);
+    while (file) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        hasher.update(chunk.data(), static_cast<size_t>(file.gcount()));
+    }
+
+    outHash = hasher.digest();
+    return true;
+}
+
+/// Split a line on a single-character delimiter
+std::vector<std::string> splitString(const std::string& text, char delimiter) {
+    std::vector<std::string> parts;
+    std::string part;
+    std::istringstream stream(text);
+    while (std::getline(stream, part, delimiter)) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+} // namespace
+
+AssetDatabase::~AssetDatabase() {
+    shutdown();
+}
+
+bool AssetDatabase::initialize(const AssetDatabaseConfig& config) {
+    m_config = config;
+    if (m_config.databasePath.empty()) {
+        m_config.databasePath = m_config.cookedRoot / "asset_db.txt";
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_config.cookedRoot, ec);
+    if (ec) {
+        std::cerr << "Failed to create cooked asset directory: " << m_config.cookedRoot
+                  << " (" << ec.message() << ")\n";
+        return false;
+    }
+
+    if (!load()) {
+        std::cout << "No asset database found, all assets will be cooked.\n";
+    }
+
+    if (!m_jobs.initialize(m_config.threadCount)) {
+        return false;
+    }
+
+    m_initialized = true;
+    return true;
+}
+
+void AssetDatabase::shutdown() {
+    if (!m_initialized) {
+        return;
+    }
+
+    m_jobs.shutdown();
+    save();
+    m_initialized = false;
+}
+
+void AssetDatabase::registerImporter(std::unique_ptr<AssetImporter> importer) {
+    m_importers.push_back(std::move(importer));
+}
+
+bool AssetDatabase::build(AssetBuildStats* stats) {
+    if (!m_initialized) {
+        std::cerr << "Asset database not initialized. Call initialize() first.\n";
+        return false;
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    // Gather every source asset that has an importer
+    std::vector<BuildNode> nodes;
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(
+             m_config.sourceRoot, std::filesystem::directory_options::skip_permission_denied, ec);
+         it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) {
+            break;
+        }
+        if (!it->is_regular_file()) {
+            continue;
+        }
+
+        const AssetImporter* importer = findImporter(it->path());
+        if (!importer) {
+            continue;
+        }
+
+        BuildNode node;
+        node.key = std::filesystem::relative(it->path(), m_config.sourceRoot).generic_string();
+        node.sourcePath = std::filesystem::absolute(it->path());
+        node.importer = importer;
+        nodes.push_back(std::move(node));
+    }
+
+    if (ec) {
+        std::cerr << "Failed to scan asset sources in " << m_config.sourceRoot << " (" << ec.message() << ")\n";
+        return false;
+    }
+
+    // Deterministic order keeps the database file and log output stable
+    std::sort(nodes.begin(), nodes.end(), [](const BuildNode& a, const BuildNode& b) { return a.key < b.key; });
+
+    hashAndScan(nodes);
+    const std::vector<size_t> order = sortNodes(nodes);
+
+    // Compute build keys in dependency order so dependents fold in their inputs' keys
+    for (size_t index : order) {
+        BuildNode& node = nodes[index];
+
+        Hasher64 hasher;
+        hasher.updateValue(node.contentHash);
+        hasher.updateString(node.importer->getName());
+        hasher.updateValue(node.importer->getVersion());
+        for (size_t dependency : node.dependencies) {
+            hasher.updateString(nodes[dependency].key);
+            hasher.updateValue(nodes[dependency].buildKey);
+            node.failed = node.failed || nodes[dependency].failed;
+        }
+        node.buildKey = hasher.digest();
+
+        auto record = m_records.find(node.key);
+        node.dirty = !node.failed && (record == m_records.end()
+            || record->second.buildKey != node.buildKey
+            || !std::filesystem::exists(artifactPathFor(node), ec));
+    }
+
+    cookDirtyNodes(nodes, order);
+
+    // Refresh records; failed assets lose theirs so the next build retries them
+    AssetBuildStats result;
+    result.totalAssets = nodes.size();
+
+    std::unordered_map<std::string, Record> records;
+    records.reserve(nodes.size());
+    for (const BuildNode& node : nodes) {
+        result.hashed += node.hashed ? 1u : 0u;
+
+        if (node.failed) {
+            result.failed++;
+            continue;
+        }
+
+        if (node.dirty) {
+            result.cooked++;
+        } else {
+            result.upToDate++;
+        }
+
+        Record record;
+        record.buildKey = node.buildKey;
+        record.contentHash = node.contentHash;
+        record.fileSize = node.fileSize;
+        record.modifiedTime = node.modifiedTime;
+        record.importer = std::string(node.importer->getName());
+        record.artifact = std::filesystem::relative(artifactPathFor(node), m_config.cookedRoot).generic_string();
+        record.dependencies = node.dependencyKeys;
+        records.emplace(node.key, std::move(record));
+    }
+
+    // Remove artifacts whose sources were deleted or changed importer
+    for (const auto& [key, record] : m_records) {
+        auto current = records.find(key);
+        if (current == records.end() || current->second.artifact != record.artifact) {
+            std::filesystem::remove(m_config.cookedRoot / record.artifact, ec);
+        }
+    }
+
+    m_records = std::move(records);
+    save();
+
+    result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << "Asset build: " << result.cooked << " cooked, " << result.upToDate << " up to date, "
+              << result.failed << " failed (" << result.hashed << " hashed, "
+              << std::fixed << std::setprecision(2) << result.elapsedSeconds << "s)\n";
+
+    if (stats) {
+        *stats = result;
+    }
+
+    return result.failed == 0;
+}
+
+std::optional<std::filesystem::path> AssetDatabase::getArtifactPath(const std::filesystem::path& sourcePath) const {
+    auto it = m_records.find(sourcePath.generic_string());
+    if (it == m_records.end()) {
+        return std::nullopt;
+    }
+    return m_config.cookedRoot / it->second.artifact;
+}
+
+std::vector<std::string> AssetDatabase::getDependencies(const std::filesystem::path& sourcePath) const {
+    auto it = m_records.find(sourcePath.generic_string());
+    if (it == m_records.end()) {
+        return {};
+    }
+    return it->second.dependencies;
+}
+
+bool AssetDatabase::load() {
+    std::ifstream file(m_config.databasePath);
+    if (!file) {
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != kDatabaseHeader) {
+        std::cerr << "Asset database has an unknown format, ignoring: " << m_config.databasePath << "\n";
+        return false;
+    }
+
+    m_records.clear();
+    while (std::getline(file, line)) {
+        auto fields = splitString(line, '\t');
+        if (fields.size() < 7) {
+            continue;
+        }
+
+        Record record;
+        try {
+            record.buildKey = std::stoull(fields[1], nullptr, 16);
+            record.contentHash = std::stoull(fields[2], nullptr, 16);
+            record.fileSize = std::stoull(fields[3]);
+            record.modifiedTime = std::stoll(fields[4]);
+        } catch (const std::exception&) {
+            continue;  // Corrupt entry: the asset simply gets re-cooked
+        }
+        record.importer = fields[5];
+        record.artifact = fields[6];
+        if (fields.size() > 7 && !fields[7].empty()) {
+            record.dependencies = splitString(fields[7], '|');
+        }
+
+        m_records.emplace(fields[0], std::move(record));
+    }
+
+    std::cout << "Asset database loaded: " << m_records.size() << " record(s).\n";
+    return true;
+}
+
+bool AssetDatabase::save() const {
+    std::ostringstream out;
+    out << kDatabaseHeader << "\n";
+
+    // Sorted so the file diffs cleanly
+    std::vector<const std::pair<const std::string, Record>*> entries;
+    entries.reserve(m_records.size());
+    for (const auto& entry : m_records) {
+        entries.push_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+    for (const auto* entry : entries) {
+        const Record& record = entry->second;
+        out << entry->first << '\t'
+            << std::hex << record.buildKey << '\t' << record.contentHash << std::dec << '\t'
+            << record.fileSize << '\t' << record.modifiedTime << '\t'
+            << record.importer << '\t' << record.artifact << '\t';
+        for (size_t i = 0; i < record.dependencies.size(); i++) {
+            out << (i > 0 ? "|" : "") << record.dependencies[i];
+        }
+        out << '\n';
+    }
+
+    const std::string text = out.str();
+    if (!writeFileAtomic(m_config.databasePath, text.data(), text.size())) {
+        std::cerr << "Failed to save asset database: " << m_config.databasePath << "\n";
+        return false;
+    }
+    return true;
+}
+
+const AssetImporter* AssetDatabase::findImporter(const std::filesystem::path& sourcePath) const {
+    for (const auto& importer : m_importers) {
+        if (importer->canImport(sourcePath)) {
+            return importer.get();
+        }
+    }
+    return nullptr;
+}
+
+void AssetDatabase::hashAndScan(std::vector<BuildNode>& nodes) {
+    m_jobs.parallelFor(nodes.size(), 16, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            BuildNode& node = nodes[i];
+            std::error_code ec;
+
+            node.fileSize = std::filesystem::file_size(node.sourcePath, ec);
+            node.modifiedTime = std::filesystem::last_write_time(node.sourcePath, ec).time_since_epoch().count();
+
+            // Unchanged size and mtime: trust the stored hash and dependency list
+            auto record = m_records.find(node.key);
+            if (record != m_records.end()
+                && record->second.fileSize == node.fileSize
+                && record->second.modifiedTime == node.modifiedTime
+                && record->second.importer == node.importer->getName()) {
+                node.contentHash = record->second.contentHash;
+                node.dependencyKeys = record->second.dependencies;
+                continue;
+            }
+
+            node.hashed = true;
+            if (!hashFile(node.sourcePath, node.contentHash)) {
+                std::cerr << "Failed to read asset source: " << node.sourcePath << "\n";
+                node.failed = true;
+                continue;
+            }
+
+            for (const auto& dependency : node.importer->scanDependencies(node.sourcePath)) {
+                node.dependencyKeys.push_back(dependency.lexically_normal().generic_string());
+            }
+            std::sort(node.dependencyKeys.begin(), node.dependencyKeys.end());
+            node.dependencyKeys.erase(
+                std::unique(node.dependencyKeys.begin(), node.dependencyKeys.end()), node.dependencyKeys.end());
+        }
+    });
+}
+
+std::vector<size_t> AssetDatabase::sortNodes(std::vector<BuildNode>& nodes) const {
+    std::unordered_map<std::string, size_t> indexByKey;
+    indexByKey.reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        indexByKey.emplace(nodes[i].key, i);
+    }
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+        for (const std::string& dependencyKey : nodes[i].dependencyKeys) {
+            auto it = indexByKey.find(dependencyKey);
+            if (it == indexByKey.end()) {
+                std::cerr << "Asset " << nodes[i].key << " depends on missing asset " << dependencyKey << "\n";
+                nodes[i].failed = true;
+                continue;
+            }
+            nodes[i].dependencies.push_back(it->second);
+            nodes[it->second].dependents.push_back(i);
+        }
+    }
+
+    // Kahn's algorithm; whatever is left over sits on a cycle
+    std::vector<size_t> remaining(nodes.size());
+    std::vector<size_t> order;
+    order.reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        remaining[i] = nodes[i].dependencies.size();
+        if (remaining[i] == 0) {
+            order.push_back(i);
+        }
+    }
+
+    for (size_t cursor = 0; cursor < order.size(); cursor++) {
+        for (size_t dependent : nodes[order[cursor]].dependents) {
+            if (--remaining[dependent] == 0) {
+                order.push_back(dependent);
+            }
+        }
+    }
+
+    if (order.size() != nodes.size()) {
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (remaining[i] != 0) {
+                std::cerr << "Asset " << nodes[i].key << " is part of a dependency cycle\n";
+                nodes[i].failed = true;
+            }
+        }
+    }
+
+    return order;
+}
+
+void AssetDatabase::cookDirtyNodes(std::vector<BuildNode>& nodes, const std::vector<size_t>& order) {
+    // A dirty node waits only on dirty dependencies; clean ones already have artifacts
+    std::vector<size_t> pendingDependencies(nodes.size(), 0);
+    size_t dirtyCount = 0;
+    for (size_t index : order) {
+        if (!nodes[index].dirty) {
+            continue;
+        }
+        dirtyCount++;
+        for (size_t dependency : nodes[index].dependencies) {
+            pendingDependencies[index] += nodes[dependency].dirty ? 1u : 0u;
+        }
+    }
+
+    if (dirtyCount == 0) {
+        return;
+    }
+
+    std::mutex mutex;
+    std::condition_variable allDone;
+    size_t finished = 0;
+
+    std::function<void(size_t)> schedule = [&](size_t index) {
+        m_jobs.submit([&, index] {
+            BuildNode& node = nodes[index];
+
+            CookContext context;
+            context.sourcePath = node.sourcePath;
+            context.outputPath = artifactPathFor(node);
+            for (size_t dependency : node.dependencies) {
+                node.failed = node.failed || nodes[dependency].failed;
+                context.dependencyArtifacts.push_back(artifactPathFor(nodes[dependency]));
+            }
+
+            if (!node.failed && !node.importer->cook(context)) {
+                std::cerr << "Failed to cook asset: " << node.key << "\n";
+                node.failed = true;
+            }
+
+            std::vector<size_t> ready;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (size_t dependent : node.dependents) {
+                    if (nodes[dependent].dirty && --pendingDependencies[dependent] == 0) {
+                        ready.push_back(dependent);
+                    }
+                }
+            }
+
+            for (size_t dependent : ready) {
+                schedule(dependent);
+            }
+
+            // Count completion last so the waiter never unwinds while this job still touches shared state
+            std::lock_guard<std::mutex> lock(mutex);
+            if (++finished == dirtyCount) {
+                allDone.notify_all();
+            }
+        });
+    };
+
+    // Collect roots before submitting anything, since running jobs decrement pending counts
+    std::vector<size_t> roots;
+    for (size_t index : order) {
+        if (nodes[index].dirty && pendingDependencies[index] == 0) {
+            roots.push_back(index);
+        }
+    }
+
+    for (size_t index : roots) {
+        schedule(index);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [&] { return finished == dirtyCount; });
+}
+
+std::filesystem::path AssetDatabase::artifactPathFor(const BuildNode& node) const {
+    auto path = m_config.cookedRoot / node.key;
+    path += node.importer->getArtifactExtension();
+    return path;
+}
+
+} // namespace ct
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "asset_pipeline/asset_importer.h"
+#include "core/job_system.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ct {
+
+/// Configuration for the asset database
+struct AssetDatabaseConfig {
+    std::filesystem::path sourceRoot = "assets";        // Root of source assets
+    std::filesystem::path cookedRoot = "cooked";        // Root of cooked artifacts
+    std::filesystem::path databasePath;                 // Defaults to <cookedRoot>/asset_db.txt
+    uint32_t threadCount = 0;                           // Cook workers (0 = all hardware threads)
+};
+
+/// Summary of a single build() call
+struct AssetBuildStats {
+    size_t totalAssets = 0;
+    size_t cooked = 0;
+    size_t upToDate = 0;
+    size_t failed = 0;
+    size_t hashed = 0;          // Sources whose contents had to be re-hashed
+    double elapsedSeconds = 0.0;
+};
+
+/// Incremental, parallel asset build graph
+///
+/// Every artifact is keyed by a hash of its source contents, its importer name and
+/// version, and the keys of everything it depends on. A build only cooks assets whose
+/// key changed, and runs independent cook jobs concurrently in dependency order.
+class AssetDatabase {
+public:
+    AssetDatabase() = default;
+    ~AssetDatabase();
+
+    // Non-copyable
+    AssetDatabase(const AssetDatabase&) = delete;
+    AssetDatabase& operator=(const AssetDatabase&) = delete;
+
+    /// Load the database from disk and start the cook workers
+    /// @param config Database configuration settings
+    /// @return true if initialization succeeded (a missing database is not an error)
+    bool initialize(const AssetDatabaseConfig& config = {});
+
+    /// Save the database and stop the cook workers
+    void shutdown();
+
+    /// Register an importer; earlier registrations take priority in canImport() matching
+    void registerImporter(std::unique_ptr<AssetImporter> importer);
+
+    /// Scan the source tree and cook every stale artifact
+    /// @param stats Optional output for build statistics
+    /// @return true if every asset is up to date afterwards
+    bool build(AssetBuildStats* stats = nullptr);
+
+    /// Get the cooked artifact path for a source asset
+    /// @param sourcePath Path relative to the source root
+    /// @return Artifact path, or nullopt if the asset has not been cooked
+    [[nodiscard]] std::optional<std::filesystem::path> getArtifactPath(const std::filesystem::path& sourcePath) const;
+
+    /// Get the source assets that the given asset depends on
+    [[nodiscard]] std::vector<std::string> getDependencies(const std::filesystem::path& sourcePath) const;
+
+private:
+    /// Persisted per-asset state from the last successful cook
+    struct Record {
+        uint64_t buildKey = 0;
+        uint64_t contentHash = 0;
+        uint64_t fileSize = 0;
+        int64_t modifiedTime = 0;
+        std::string importer;
+        std::string artifact;               // Relative to the cooked root
+        std::vector<std::string> dependencies;
+    };
+
+    /// Transient per-asset state for one build
+    struct BuildNode {
+        std::string key;                    // Source path relative to the source root (generic format)
+        std::filesystem::path sourcePath;
+        const AssetImporter* importer = nullptr;
+        uint64_t fileSize = 0;
+        int64_t modifiedTime = 0;
+        uint64_t contentHash = 0;
+        uint64_t buildKey = 0;
+        bool hashed = false;
+        bool dirty = false;
+        bool failed = false;
+        std::vector<std::string> dependencyKeys;
+        std::vector<size_t> dependencies;   // Indices into the node list
+        std::vector<size_t> dependents;
+    };
+
+    /// Read the database file
+    bool load();
+
+    /// Write the database file
+    bool save() const;
+
+    /// Find the first importer that accepts a source file
+    const AssetImporter* findImporter(const std::filesystem::path& sourcePath) const;
+
+    /// Hash sources (skipping unchanged size/mtime) and scan their dependencies in parallel
+    void hashAndScan(std::vector<BuildNode>& nodes);
+
+    /// Resolve dependency edges and produce a topological order
+    /// @return Node indices in dependency order; nodes in cycles are marked failed and omitted
+    std::vector<size_t> sortNodes(std::vector<BuildNode>& nodes) const;
+
+    /// Cook all dirty nodes in parallel, respecting dependency order
+    void cookDirtyNodes(std::vector<BuildNode>& nodes, const std::vector<size_t>& order);
+
+    /// Get the artifact path for a node
+    std::filesystem::path artifactPathFor(const BuildNode& node) const;
+
+    AssetDatabaseConfig m_config;
+    JobSystem m_jobs;
+    std::vector<std::unique_ptr<AssetImporter>> m_importers;
+    std::unordered_map<std::string, Record> m_records;
+    bool m_initialized = false;
+};
+
+} // namespace ct
@@ -0,0 +1,57 @@
+#include "asset_pipeline/asset_importer.h"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <system_error>
+#include <thread>
+
+namespace ct {
+
+bool RawCopyImporter::canImport(const std::filesystem::path& sourcePath) const {
+    return std::filesystem::is_regular_file(sourcePath);
+}
+
+bool RawCopyImporter::cook(const CookContext& context) const {
+    std::ifstream file(context.sourcePath, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open asset source: " << context.sourcePath << "\n";
+        return false;
+    }
+
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return writeFileAtomic(context.outputPath, bytes.data(), bytes.size());
+}
+
+bool writeFileAtomic(const std::filesystem::path& path, const void* data, size_t size) {
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    // Unique per thread so concurrent cooks of different assets never share a temp file
+    auto tempPath = path;
+    tempPath += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Failed to open artifact for writing: " << tempPath << "\n";
+            return false;
+        }
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        if (!file) {
+            std::cerr << "Failed to write artifact: " << tempPath << "\n";
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::cerr << "Failed to move artifact into place: " << path << " (" << ec.message() << ")\n";
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace ct
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ct {
+
+/// Everything an importer needs to cook a single source asset
+struct CookContext {
+    std::filesystem::path sourcePath;                       // Absolute path of the source file
+    std::filesystem::path outputPath;                       // Absolute path the artifact must be written to
+    std::vector<std::filesystem::path> dependencyArtifacts; // Cooked outputs of declared dependencies
+};
+
+/// Generic asset import interface
+/// Importers are shared between cook jobs and must be safe to call concurrently
+class AssetImporter {
+public:
+    virtual ~AssetImporter() = default;
+
+    /// Unique importer name, recorded with every artifact it produces
+    [[nodiscard]] virtual std::string_view getName() const = 0;
+
+    /// Importer version; bump whenever the cooked output changes so old artifacts are rebuilt
+    [[nodiscard]] virtual uint32_t getVersion() const = 0;
+
+    /// Check whether this importer handles the given source file
+    [[nodiscard]] virtual bool canImport(const std::filesystem::path& sourcePath) const = 0;
+
+    /// File extension appended to cooked artifacts (including the dot)
+    [[nodiscard]] virtual std::string getArtifactExtension() const { return ".bin"; }
+
+    /// List other source assets this asset reads while cooking
+    /// @param sourcePath Absolute path of the source file
+    /// @return Dependency paths relative to the asset source root
+    [[nodiscard]] virtual std::vector<std::filesystem::path> scanDependencies(
+        [[maybe_unused]] const std::filesystem::path& sourcePath) const {
+        return {};
+    }
+
+    /// Produce the cooked artifact
+    /// @param context Source, output and dependency paths
+    /// @return true if the artifact was written
+    virtual bool cook(const CookContext& context) const = 0;
+};
+
+/// Fallback importer that copies the source file unchanged
+class RawCopyImporter : public AssetImporter {
+public:
+    [[nodiscard]] std::string_view getName() const override { return "raw_copy"; }
+    [[nodiscard]] uint32_t getVersion() const override { return 1; }
+    [[nodiscard]] bool canImport(const std::filesystem::path& sourcePath) const override;
+    [[nodiscard]] std::string getArtifactExtension() const override { return ""; }
+    bool cook(const CookContext& context) const override;
+};
+
+/// Write a file via a temporary sibling and rename, so readers never observe partial artifacts
+/// @param path Destination path (parent directories are created)
+/// @param data Bytes to write
+/// @param size Number of bytes
+/// @return true if the file was written
+bool writeFileAtomic(const std::filesystem::path& path, const void* data, size_t size);
+
+} // namespace ct
@@ -0,0 +1,550 @@
+#include "asset_pipeline/blender_bridge/mesh_processor.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+namespace ct {
+
+namespace {
+
+constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+// Forsyth vertex cache optimization tuning (values from the original paper)
+constexpr size_t kForsythCacheSize = 32;
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kLastTriangleScore = 0.75f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+
+// Vertex fetch model: direct-mapped cache of 64-byte lines
+constexpr size_t kFetchLineSize = 64;
+constexpr size_t kFetchLineCount = 256;
+
+/// Score of a vertex given its cache position (-1 = not cached) and remaining triangle count
+float forsythVertexScore(int32_t cachePosition, uint32_t remainingTriangles) {
+    if (remainingTriangles == 0) {
+        return -1.0f;  // No triangles left to emit, never worth picking
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // Vertices of the last triangle get a fixed score so its neighbors aren't favored unfairly
+            score = kLastTriangleScore;
+        } else {
+            const float scaler = 1.0f / static_cast<float>(kForsythCacheSize - 3);
+            score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, kCacheDecayPower);
+        }
+    }
+
+    // Boost vertices with few triangles left so they are finished off and leave the cache
+    score += kValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -kValenceBoostPower);
+    return score;
+}
+
+/// Count vertices referenced at least once
+size_t countReferencedVertices(const std::vector<uint32_t>& indices, size_t vertexCount) {
+    std::vector<uint8_t> referenced(vertexCount, 0);
+    size_t count = 0;
+    for (uint32_t index : indices) {
+        if (!referenced[index]) {
+            referenced[index] = 1;
+            count++;
+        }
+    }
+    return count;
+}
+
+uint16_t quantizeUnorm16(float value) {
+    return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+int16_t quantizeSnorm16(float value) {
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+uint8_t quantizeUnorm8(float value) {
+    return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+} // namespace
+
+bool MeshProcessor::process(const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices,
+                            ProcessedMesh& output) const {
+    if (indices.size() % 3 != 0) {
+        std::cerr << "Mesh index count " << indices.size() << " is not a multiple of 3\n";
+        return false;
+    }
+
+    for (uint32_t index : indices) {
+        if (index >= vertices.size()) {
+            std::cerr << "Mesh index " << index << " out of range (" << vertices.size() << " vertices)\n";
+            return false;
+        }
+    }
+
+    // Meshlet-local indices are stored as uint8_t
+    if (m_config.buildMeshlets && (m_config.maxMeshletVertices < 3 || m_config.maxMeshletVertices > 256
+                                   || m_config.maxMeshletTriangles == 0)) {
+        std::cerr << "Invalid meshlet limits: " << m_config.maxMeshletVertices << " vertices, "
+                  << m_config.maxMeshletTriangles << " triangles\n";
+        return false;
+    }
+
+    output = {};
+    MeshOptimizationStats& stats = output.stats;
+    const size_t triangleCount = indices.size() / 3;
+
+    const size_t referencedBefore = countReferencedVertices(indices, vertices.size());
+    const size_t missesBefore = countCacheMisses(indices, vertices.size(), m_config.cacheSize);
+    stats.vertexBytesBefore = vertices.size() * sizeof(MeshVertex);
+    stats.fetchBytesBefore = estimateFetchBytes(indices, vertices.size(), sizeof(MeshVertex), m_config.cacheSize);
+
+    std::vector<uint32_t> optimizedIndices = m_config.optimizeVertexCache
+        ? optimizeVertexCache(indices, vertices.size())
+        : indices;
+
+    std::vector<MeshVertex> optimizedVertices;
+    if (m_config.optimizeVertexFetch) {
+        const std::vector<uint32_t> remap = optimizeVertexFetch(optimizedIndices, vertices.size());
+        optimizedVertices.resize(referencedBefore);
+        for (size_t i = 0; i < vertices.size(); i++) {
+            if (remap[i] != kInvalidIndex) {
+                optimizedVertices[remap[i]] = vertices[i];
+            }
+        }
+    } else {
+        optimizedVertices = vertices;
+    }
+
+    quantize(optimizedVertices, output);
+    output.indices = std::move(optimizedIndices);
+
+    const size_t referencedAfter = countReferencedVertices(output.indices, output.vertices.size());
+    const size_t missesAfter = countCacheMisses(output.indices, output.vertices.size(), m_config.cacheSize);
+    stats.vertexBytesAfter = output.vertices.size() * sizeof(QuantizedVertex);
+    stats.fetchBytesAfter = estimateFetchBytes(
+        output.indices, output.vertices.size(), sizeof(QuantizedVertex), m_config.cacheSize);
+
+    if (triangleCount > 0) {
+        stats.acmrBefore = static_cast<float>(missesBefore) / static_cast<float>(triangleCount);
+        stats.acmrAfter = static_cast<float>(missesAfter) / static_cast<float>(triangleCount);
+        stats.atvrBefore = static_cast<float>(missesBefore) / static_cast<float>(referencedBefore);
+        stats.atvrAfter = static_cast<float>(missesAfter) / static_cast<float>(referencedAfter);
+    }
+
+    if (m_config.buildMeshlets) {
+        buildMeshlets(optimizedVertices, output);
+    }
+
+    const auto reduction = [](size_t before, size_t after) {
+        return before > 0 ? 100.0 * (1.0 - static_cast<double>(after) / static_cast<double>(before)) : 0.0;
+    };
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "Mesh optimized: " << triangleCount << " triangles, "
+              << "ACMR " << stats.acmrBefore << " -> " << stats.acmrAfter << ", "
+              << "ATVR " << stats.atvrBefore << " -> " << stats.atvrAfter << "\n"
+              << std::setprecision(1)
+              << "  Vertex buffer: " << stats.vertexBytesBefore / 1024 << " KB -> "
+              << stats.vertexBytesAfter / 1024 << " KB (-" << reduction(stats.vertexBytesBefore, stats.vertexBytesAfter) << "%)\n"
+              << "  Vertex fetch:  " << stats.fetchBytesBefore / 1024 << " KB -> "
+              << stats.fetchBytesAfter / 1024 << " KB (-" << reduction(stats.fetchBytesBefore, stats.fetchBytesAfter) << "%)\n"
+              << std::setprecision(6)
+              << "  Max error: position " << stats.maxPositionError
+              << ", normal " << stats.maxNormalErrorDegrees << " deg"
+              << ", uv " << stats.maxUvError << "\n"
+              << "  Meshlets: " << stats.meshletCount << "\n";
+
+    return true;
+}
+
+std::vector<uint32_t> MeshProcessor::optimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return indices;
+    }
+
+    // Vertex -> triangle adjacency in CSR form; the first remaining[v] entries are still unemitted
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (uint32_t index : indices) {
+        remaining[index]++;
+    }
+
+    std::vector<size_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remaining[v];
+    }
+
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<size_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        vertexScore[v] = forsythVertexScore(-1, remaining[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    size_t bestTriangle = 0;
+    for (size_t t = 0; t < triangleCount; t++) {
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+        if (triangleScore[t] > triangleScore[bestTriangle]) {
+            bestTriangle = t;
+        }
+    }
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+
+    std::array<uint32_t, kForsythCacheSize + 3> cache{};
+    std::array<uint32_t, kForsythCacheSize + 3> newCache{};
+    size_t cacheCount = 0;
+    size_t scanCursor = 0;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        if (bestTriangle == kInvalidIndex) {
+            // Nothing adjacent to the cache: restart from the next unemitted triangle in input order
+            while (emitted[scanCursor]) {
+                scanCursor++;
+            }
+            bestTriangle = scanCursor;
+        }
+
+        const size_t triangle = bestTriangle;
+        emitted[triangle] = 1;
+
+        size_t newCacheCount = 0;
+        for (size_t corner = 0; corner < 3; corner++) {
+            const uint32_t v = indices[triangle * 3 + corner];
+            result.push_back(v);
+            newCache[newCacheCount++] = v;
+
+            // Remove the triangle from this vertex's remaining adjacency
+            const size_t begin = adjacencyOffsets[v];
+            const size_t end = begin + remaining[v];
+            for (size_t i = begin; i < end; i++) {
+                if (adjacency[i] == triangle) {
+                    std::swap(adjacency[i], adjacency[end - 1]);
+                    break;
+                }
+            }
+            remaining[v]--;
+        }
+
+        for (size_t i = 0; i < cacheCount; i++) {
+            const uint32_t v = cache[i];
+            if (v != newCache[0] && v != newCache[1] && v != newCache[2]) {
+                newCache[newCacheCount++] = v;
+            }
+        }
+
+        // Entries past the cache size were evicted; they are rescored too
+        for (size_t i = 0; i < newCacheCount; i++) {
+            const uint32_t v = newCache[i];
+            cachePosition[v] = i < kForsythCacheSize ? static_cast<int32_t>(i) : -1;
+            vertexScore[v] = forsythVertexScore(cachePosition[v], remaining[v]);
+        }
+
+        bestTriangle = kInvalidIndex;
+        float bestScore = -1.0f;
+        for (size_t i = 0; i < newCacheCount; i++) {
+            const uint32_t v = newCache[i];
+            const size_t begin = adjacencyOffsets[v];
+            for (size_t j = begin; j < begin + remaining[v]; j++) {
+                const uint32_t t = adjacency[j];
+                const float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]]
+                    + vertexScore[indices[t * 3 + 2]];
+                triangleScore[t] = score;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCacheCount, kForsythCacheSize);
+        std::copy(newCache.begin(), newCache.begin() + static_cast<std::ptrdiff_t>(cacheCount), cache.begin());
+    }
+
+    return result;
+}
+
+std::vector<uint32_t> MeshProcessor::optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount) {
+    std::vector<uint32_t> remap(vertexCount, kInvalidIndex);
+    uint32_t nextVertex = 0;
+
+    for (uint32_t& index : indices) {
+        if (remap[index] == kInvalidIndex) {
+            remap[index] = nextVertex++;
+        }
+        index = remap[index];
+    }
+
+    return remap;
+}
+
+size_t MeshProcessor::countCacheMisses(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+    // A vertex is cached if fewer than cacheSize misses happened since it was inserted
+    std::vector<size_t> insertedAt(vertexCount, 0);
+    size_t time = static_cast<size_t>(cacheSize) + 1;
+    size_t misses = 0;
+
+    for (uint32_t index : indices) {
+        if (time - insertedAt[index] > cacheSize) {
+            insertedAt[index] = time++;
+            misses++;
+        }
+    }
+
+    return misses;
+}
+
+size_t MeshProcessor::estimateFetchBytes(const std::vector<uint32_t>& indices, size_t vertexCount,
+                                         size_t vertexStride, uint32_t cacheSize) {
+    std::vector<size_t> insertedAt(vertexCount, 0);
+    size_t time = static_cast<size_t>(cacheSize) + 1;
+
+    std::vector<size_t> lineTags(kFetchLineCount, std::numeric_limits<size_t>::max());
+    size_t bytes = 0;
+
+    for (uint32_t index : indices) {
+        if (time - insertedAt[index] <= cacheSize) {
+            continue;  // Post-transform cache hit: no fetch
+        }
+        insertedAt[index] = time++;
+
+        const size_t firstLine = index * vertexStride / kFetchLineSize;
+        const size_t lastLine = (index * vertexStride + vertexStride - 1) / kFetchLineSize;
+        for (size_t line = firstLine; line <= lastLine; line++) {
+            size_t& tag = lineTags[line % kFetchLineCount];
+            if (tag != line) {
+                tag = line;
+                bytes += kFetchLineSize;
+            }
+        }
+    }
+
+    return bytes;
+}
+
+glm::vec2 MeshProcessor::encodeOctahedral(glm::vec3 normal) {
+    const float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (sum <= 0.0f) {
+        return glm::vec2(0.0f, 0.0f);  // Degenerate normal maps to +Z
+    }
+
+    glm::vec2 encoded(normal.x / sum, normal.y / sum);
+    if (normal.z < 0.0f) {
+        // Fold the lower hemisphere over the diagonals
+        encoded = glm::vec2(
+            (1.0f - std::abs(encoded.y)) * (encoded.x >= 0.0f ? 1.0f : -1.0f),
+            (1.0f - std::abs(encoded.x)) * (encoded.y >= 0.0f ? 1.0f : -1.0f));
+    }
+    return encoded;
+}
+
+glm::vec3 MeshProcessor::decodeOctahedral(glm::vec2 encoded) {
+    glm::vec3 normal(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+    const float t = std::max(-normal.z, 0.0f);
+    normal.x += normal.x >= 0.0f ? -t : t;
+    normal.y += normal.y >= 0.0f ? -t : t;
+    return glm::normalize(normal);
+}
+
+void MeshProcessor::quantize(const std::vector<MeshVertex>& vertices, ProcessedMesh& output) const {
+    glm::vec3 positionMin(std::numeric_limits<float>::max());
+    glm::vec3 positionMax(std::numeric_limits<float>::lowest());
+    glm::vec2 uvMin(std::numeric_limits<float>::max());
+    glm::vec2 uvMax(std::numeric_limits<float>::lowest());
+
+    for (const MeshVertex& vertex : vertices) {
+        positionMin = glm::min(positionMin, vertex.position);
+        positionMax = glm::max(positionMax, vertex.position);
+        uvMin = glm::min(uvMin, vertex.uv);
+        uvMax = glm::max(uvMax, vertex.uv);
+    }
+
+    if (vertices.empty()) {
+        positionMin = positionMax = glm::vec3(0.0f);
+        uvMin = uvMax = glm::vec2(0.0f);
+    }
+
+    // Flat axes keep a unit extent so dequantization never divides by zero
+    glm::vec3 positionExtent = positionMax - positionMin;
+    glm::vec2 uvExtent = uvMax - uvMin;
+    for (int axis = 0; axis < 3; axis++) {
+        positionExtent[axis] = positionExtent[axis] > 0.0f ? positionExtent[axis] : 1.0f;
+    }
+    for (int axis = 0; axis < 2; axis++) {
+        uvExtent[axis] = uvExtent[axis] > 0.0f ? uvExtent[axis] : 1.0f;
+    }
+
+    output.quantization.positionOffset = glm::vec4(positionMin, 0.0f);
+    output.quantization.positionScale = glm::vec4(positionExtent, 0.0f);
+    output.quantization.uvOffsetScale = glm::vec4(uvMin.x, uvMin.y, uvExtent.x, uvExtent.y);
+
+    MeshOptimizationStats& stats = output.stats;
+    output.vertices.resize(vertices.size());
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const MeshVertex& source = vertices[i];
+        QuantizedVertex& target = output.vertices[i];
+
+        const glm::vec3 position = (source.position - positionMin) / positionExtent;
+        glm::vec3 decodedPosition = positionMin;
+        for (int axis = 0; axis < 3; axis++) {
+            target.position[axis] = quantizeUnorm16(position[axis]);
+            decodedPosition[axis] += static_cast<float>(target.position[axis]) / 65535.0f * positionExtent[axis];
+        }
+        target.position[3] = 0;
+        stats.maxPositionError = std::max(stats.maxPositionError, glm::length(decodedPosition - source.position));
+
+        const float normalLength = glm::length(source.normal);
+        const glm::vec3 normal = normalLength > 0.0f ? source.normal / normalLength : glm::vec3(0.0f, 0.0f, 1.0f);
+        const glm::vec2 octahedral = encodeOctahedral(normal);
+        target.normal[0] = quantizeSnorm16(octahedral.x);
+        target.normal[1] = quantizeSnorm16(octahedral.y);
+        const glm::vec3 decodedNormal = decodeOctahedral(glm::vec2(
+            static_cast<float>(target.normal[0]) / 32767.0f, static_cast<float>(target.normal[1]) / 32767.0f));
+        const float normalError = std::acos(std::clamp(glm::dot(normal, decodedNormal), -1.0f, 1.0f));
+        stats.maxNormalErrorDegrees = std::max(stats.maxNormalErrorDegrees, normalError * 57.2957795f);
+
+        const glm::vec2 uv = (source.uv - uvMin) / uvExtent;
+        target.uv[0] = quantizeUnorm16(uv.x);
+        target.uv[1] = quantizeUnorm16(uv.y);
+        const glm::vec2 decodedUv(
+            uvMin.x + static_cast<float>(target.uv[0]) / 65535.0f * uvExtent.x,
+            uvMin.y + static_cast<float>(target.uv[1]) / 65535.0f * uvExtent.y);
+        stats.maxUvError = std::max(stats.maxUvError, glm::length(decodedUv - source.uv));
+
+        target.color[0] = quantizeUnorm8(source.color.x);
+        target.color[1] = quantizeUnorm8(source.color.y);
+        target.color[2] = quantizeUnorm8(source.color.z);
+        target.color[3] = 255;
+    }
+}
+
+void MeshProcessor::buildMeshlets(const std::vector<MeshVertex>& vertices, ProcessedMesh& output) const {
+    const std::vector<uint32_t>& indices = output.indices;
+    std::vector<uint32_t> localIndex(vertices.size(), kInvalidIndex);
+    Meshlet current;
+
+    const auto finishMeshlet = [&] {
+        if (current.triangleCount == 0) {
+            return;
+        }
+
+        const uint32_t* meshletVertices = output.meshletVertices.data() + current.vertexOffset;
+        const uint8_t* meshletTriangles = output.meshletTriangles.data() + current.triangleOffset;
+
+        // Bounding sphere around the AABB center, padded by the quantization error
+        glm::vec3 boundsMin(std::numeric_limits<float>::max());
+        glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+        for (uint32_t i = 0; i < current.vertexCount; i++) {
+            boundsMin = glm::min(boundsMin, vertices[meshletVertices[i]].position);
+            boundsMax = glm::max(boundsMax, vertices[meshletVertices[i]].position);
+        }
+
+        MeshletBounds bounds;
+        bounds.center = (boundsMin + boundsMax) * 0.5f;
+        for (uint32_t i = 0; i < current.vertexCount; i++) {
+            bounds.radius = std::max(bounds.radius, glm::distance(bounds.center, vertices[meshletVertices[i]].position));
+        }
+        bounds.radius += output.stats.maxPositionError;
+
+        // Normal cone from the average triangle normal
+        std::vector<glm::vec3> normals;
+        normals.reserve(current.triangleCount);
+        glm::vec3 axis(0.0f);
+        for (uint32_t t = 0; t < current.triangleCount; t++) {
+            const glm::vec3& p0 = vertices[meshletVertices[meshletTriangles[t * 3]]].position;
+            const glm::vec3& p1 = vertices[meshletVertices[meshletTriangles[t * 3 + 1]]].position;
+            const glm::vec3& p2 = vertices[meshletVertices[meshletTriangles[t * 3 + 2]]].position;
+            const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            const float area = glm::length(normal);
+            if (area > 0.0f) {
+                normals.push_back(normal / area);
+                axis += normal / area;
+            }
+        }
+
+        const float axisLength = glm::length(axis);
+        if (axisLength > 0.0f) {
+            axis /= axisLength;
+
+            float minDot = 1.0f;
+            for (const glm::vec3& normal : normals) {
+                minDot = std::min(minDot, glm::dot(normal, axis));
+            }
+
+            // A cone wider than a hemisphere can't reject anything
+            if (minDot > 0.0f) {
+                float maxT = 0.0f;
+                size_t normalIndex = 0;
+                for (uint32_t t = 0; t < current.triangleCount; t++) {
+                    const glm::vec3& p0 = vertices[meshletVertices[meshletTriangles[t * 3]]].position;
+                    const glm::vec3& p1 = vertices[meshletVertices[meshletTriangles[t * 3 + 1]]].position;
+                    const glm::vec3& p2 = vertices[meshletVertices[meshletTriangles[t * 3 + 2]]].position;
+                    if (glm::length(glm::cross(p1 - p0, p2 - p0)) <= 0.0f) {
+                        continue;
+                    }
+                    const glm::vec3& normal = normals[normalIndex++];
+                    maxT = std::max(maxT, glm::dot(bounds.center - p0, normal) / glm::dot(axis, normal));
+                }
+
+                bounds.coneApex = bounds.center - axis * maxT;
+                bounds.coneAxis = axis;
+                bounds.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+            }
+        }
+
+        for (uint32_t i = 0; i < current.vertexCount; i++) {
+            localIndex[meshletVertices[i]] = kInvalidIndex;
+        }
+
+        output.meshlets.push_back(current);
+        output.meshletBounds.push_back(bounds);
+
+        current = {};
+        current.vertexOffset = static_cast<uint32_t>(output.meshletVertices.size());
+        current.triangleOffset = static_cast<uint32_t>(output.meshletTriangles.size());
+    };
+
+    for (size_t t = 0; t < indices.size() / 3; t++) {
+        uint32_t newVertices = 0;
+        for (size_t corner = 0; corner < 3; corner++) {
+            newVertices += localIndex[indices[t * 3 + corner]] == kInvalidIndex ? 1u : 0u;
+        }
+
+        if (current.vertexCount + newVertices > m_config.maxMeshletVertices
+            || current.triangleCount + 1 > m_config.maxMeshletTriangles) {
+            finishMeshlet();
+        }
+
+        for (size_t corner = 0; corner < 3; corner++) {
+            uint32_t& local = localIndex[indices[t * 3 + corner]];
+            if (local == kInvalidIndex) {
+                local = current.vertexCount++;
+                output.meshletVertices.push_back(indices[t * 3 + corner]);
+            }
+            output.meshletTriangles.push_back(static_cast<uint8_t>(local));
+        }
+        current.triangleCount++;
+    }
+
+    finishMeshlet();
+    output.stats.meshletCount = output.meshlets.size();
+}
+
+} // namespace ct
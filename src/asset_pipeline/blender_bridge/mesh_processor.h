@@ -0,0 +1,123 @@
+#pragma once
+
+#include "rendering/vertex_formats.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ct {
+
+/// Full-precision vertex as it arrives from an importer (44 bytes)
+struct MeshVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec3 color;
+    glm::vec2 uv;
+};
+
+/// A cluster of triangles small enough for per-cluster culling
+struct Meshlet {
+    uint32_t vertexOffset = 0;      // First entry in ProcessedMesh::meshletVertices
+    uint32_t triangleOffset = 0;    // First entry in ProcessedMesh::meshletTriangles (3 per triangle)
+    uint32_t vertexCount = 0;
+    uint32_t triangleCount = 0;
+};
+
+/// Culling bounds for a meshlet
+/// Backface cone test: cull if dot(normalize(coneApex - cameraPosition), coneAxis) >= coneCutoff
+struct MeshletBounds {
+    glm::vec3 center{0.0f};
+    float radius = 0.0f;
+    glm::vec3 coneApex{0.0f};
+    glm::vec3 coneAxis{0.0f};
+    float coneCutoff = 1.0f;        // 1 disables cone culling
+};
+
+/// Before/after figures reported by MeshProcessor::process()
+struct MeshOptimizationStats {
+    float acmrBefore = 0.0f;            // Post-transform cache misses per triangle
+    float acmrAfter = 0.0f;
+    float atvrBefore = 0.0f;            // Post-transform cache misses per vertex
+    float atvrAfter = 0.0f;
+    size_t vertexBytesBefore = 0;       // Vertex buffer size
+    size_t vertexBytesAfter = 0;
+    size_t fetchBytesBefore = 0;        // Simulated vertex fetch bandwidth for one draw
+    size_t fetchBytesAfter = 0;
+    float maxPositionError = 0.0f;      // Largest quantization error, in mesh units
+    float maxNormalErrorDegrees = 0.0f;
+    float maxUvError = 0.0f;
+    size_t meshletCount = 0;
+};
+
+/// Configuration for mesh processing
+struct MeshProcessorConfig {
+    uint32_t cacheSize = 16;                // Post-transform cache size used for ACMR analysis
+    uint32_t maxMeshletVertices = 64;
+    uint32_t maxMeshletTriangles = 124;
+    bool optimizeVertexCache = true;
+    bool optimizeVertexFetch = true;
+    bool buildMeshlets = true;
+};
+
+/// Output of the mesh processor, ready for upload
+struct ProcessedMesh {
+    std::vector<QuantizedVertex> vertices;
+    std::vector<uint32_t> indices;
+    QuantizationParams quantization;
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshletBounds> meshletBounds;
+    std::vector<uint32_t> meshletVertices;  // Indices into vertices
+    std::vector<uint8_t> meshletTriangles;  // Meshlet-local vertex indices, 3 per triangle
+    MeshOptimizationStats stats;
+};
+
+/// Optimizes imported triangle meshes for GPU rendering
+/// Reorders for the post-transform cache and vertex fetch, quantizes attributes and builds meshlets
+class MeshProcessor {
+public:
+    explicit MeshProcessor(const MeshProcessorConfig& config = {}) : m_config(config) {}
+
+    /// Run the full optimization pipeline on an indexed triangle list
+    /// @param vertices Source vertices
+    /// @param indices Triangle list indices (size must be a multiple of 3)
+    /// @param output Receives the optimized mesh and statistics
+    /// @return true if processing succeeded
+    bool process(const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices,
+                 ProcessedMesh& output) const;
+
+    /// Reorder triangles to maximize post-transform cache hits (Forsyth's linear-speed algorithm)
+    static std::vector<uint32_t> optimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount);
+
+    /// Reorder vertices into first-use order and drop unreferenced ones
+    /// @param indices Rewritten in place to reference the new vertex order
+    /// @return remap[oldIndex] = newIndex, or UINT32_MAX for dropped vertices
+    static std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount);
+
+    /// Simulate a FIFO post-transform cache
+    /// @return Number of vertex shader invocations (cache misses)
+    static size_t countCacheMisses(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize);
+
+    /// Estimate bytes fetched from memory for one draw through a small line cache
+    static size_t estimateFetchBytes(const std::vector<uint32_t>& indices, size_t vertexCount,
+                                     size_t vertexStride, uint32_t cacheSize);
+
+    /// Encode a unit vector into octahedral coordinates in [-1, 1]^2
+    static glm::vec2 encodeOctahedral(glm::vec3 normal);
+
+    /// Decode octahedral coordinates into a unit vector
+    static glm::vec3 decodeOctahedral(glm::vec2 encoded);
+
+private:
+    /// Quantize vertices and measure round-trip error
+    void quantize(const std::vector<MeshVertex>& vertices, ProcessedMesh& output) const;
+
+    /// Greedily split the index buffer into meshlets and compute their bounds
+    void buildMeshlets(const std::vector<MeshVertex>& vertices, ProcessedMesh& output) const;
+
+    MeshProcessorConfig m_config;
+};
+
+} // namespace ct
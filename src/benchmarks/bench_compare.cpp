@@ -0,0 +1,127 @@
+#include "benchmarks/benchmark.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Compares a benchmark result file against a stored baseline and fails on regressions.
+//
+// Usage: BenchCompare baseline.json current.json [--threshold 0.10] [--metric-threshold 0.0]
+//
+// A timing regresses when both its median and its minimum are slower than the baseline by more
+// than the threshold; requiring both keeps one noisy sample from failing the run. Metrics
+// (barrier counts, bytes, ...) are deterministic and lower is better, so they regress on any
+// increase beyond the metric threshold. Benchmarks missing from the current run also fail.
+
+namespace {
+
+const ct::BenchmarkResult* findResult(const std::vector<ct::BenchmarkResult>& results, const std::string& name) {
+    for (const ct::BenchmarkResult& result : results) {
+        if (result.name == name) {
+            return &result;
+        }
+    }
+    return nullptr;
+}
+
+std::string formatChange(double ratio) {
+    std::ostringstream text;
+    text << std::showpos << std::fixed << std::setprecision(1) << (ratio - 1.0) * 100.0 << "%";
+    return text.str();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: BenchCompare baseline.json current.json [--threshold 0.10] [--metric-threshold 0.0]\n";
+        return EXIT_FAILURE;
+    }
+
+    double threshold = 0.10;
+    double metricThreshold = 0.0;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        const std::string arg = argv[i];
+        if (arg == "--threshold") {
+            threshold = std::strtod(argv[i + 1], nullptr);
+        } else if (arg == "--metric-threshold") {
+            metricThreshold = std::strtod(argv[i + 1], nullptr);
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    ct::BenchmarkMachine baselineMachine;
+    ct::BenchmarkMachine currentMachine;
+    std::vector<ct::BenchmarkResult> baseline;
+    std::vector<ct::BenchmarkResult> current;
+    if (!ct::readBenchmarkResults(argv[1], baselineMachine, baseline) ||
+        !ct::readBenchmarkResults(argv[2], currentMachine, current)) {
+        return EXIT_FAILURE;
+    }
+
+    if (baselineMachine.hardwareThreads != currentMachine.hardwareThreads ||
+        baselineMachine.compiler != currentMachine.compiler || baselineMachine.buildType != currentMachine.buildType ||
+        baselineMachine.gpu != currentMachine.gpu) {
+        std::cout << "Warning: baseline was recorded on a different machine or build ("
+                  << baselineMachine.hardwareThreads << " threads, " << baselineMachine.compiler << ", "
+                  << baselineMachine.buildType << ", " << baselineMachine.gpu << "); timings may not be comparable\n";
+    }
+
+    uint32_t regressions = 0;
+    uint32_t improvements = 0;
+    uint32_t missing = 0;
+
+    for (const ct::BenchmarkResult& base : baseline) {
+        const ct::BenchmarkResult* result = findResult(current, base.name);
+        if (!result) {
+            std::cout << "MISSING   " << base.name << "\n";
+            missing++;
+            continue;
+        }
+
+        const double medianRatio = base.medianNs > 0.0 ? result->medianNs / base.medianNs : 1.0;
+        const double minRatio = base.minNs > 0.0 ? result->minNs / base.minNs : 1.0;
+        const char* status = "ok        ";
+        if (medianRatio > 1.0 + threshold && minRatio > 1.0 + threshold) {
+            status = "REGRESSED ";
+            regressions++;
+        } else if (medianRatio < 1.0 - threshold && minRatio < 1.0 - threshold) {
+            status = "improved  ";
+            improvements++;
+        }
+        std::cout << status << base.name << ": median " << formatChange(medianRatio) << ", min "
+                  << formatChange(minRatio) << "\n";
+
+        for (const auto& [metric, baseValue] : base.metrics) {
+            const auto it = result->metrics.find(metric);
+            if (it == result->metrics.end()) {
+                std::cout << "MISSING   " << base.name << " metric " << metric << "\n";
+                missing++;
+                continue;
+            }
+            if (it->second > baseValue * (1.0 + metricThreshold) + 1e-9) {
+                std::cout << "REGRESSED " << base.name << " metric " << metric << ": " << baseValue << " -> "
+                          << it->second << "\n";
+                regressions++;
+            } else if (it->second < baseValue) {
+                std::cout << "improved  " << base.name << " metric " << metric << ": " << baseValue << " -> "
+                          << it->second << "\n";
+            }
+        }
+    }
+
+    for (const ct::BenchmarkResult& result : current) {
+        if (!findResult(baseline, result.name)) {
+            std::cout << "new       " << result.name << " (not in baseline)\n";
+        }
+    }
+
+    std::cout << regressions << " regressions, " << improvements << " improvements, " << missing
+              << " missing (threshold " << threshold * 100.0 << "%)\n";
+    return regressions == 0 && missing == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
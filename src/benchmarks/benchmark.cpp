@@ -0,0 +1,441 @@
+#include "benchmarks/benchmark.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace ct {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) >= 0x20) {
+                    escaped += c;
+                }
+                break;
+        }
+    }
+    return escaped;
+}
+
+/// Reader for the subset of JSON that writeBenchmarkResults() produces
+class JsonReader {
+public:
+    explicit JsonReader(std::string text) : m_text(std::move(text)) {}
+
+    bool expect(char c) {
+        skipSpace();
+        if (m_pos < m_text.size() && m_text[m_pos] == c) {
+            m_pos++;
+            return true;
+        }
+        return false;
+    }
+
+    /// Consume the closing bracket or a separating comma
+    /// @return true if another element follows
+    bool next(char close) {
+        if (expect(',')) {
+            return true;
+        }
+        if (!expect(close)) {
+            m_failed = true;
+        }
+        return false;
+    }
+
+    bool readString(std::string& value) {
+        value.clear();
+        if (!expect('"')) {
+            return false;
+        }
+        while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+            char c = m_text[m_pos++];
+            if (c == '\\' && m_pos < m_text.size()) {
+                c = m_text[m_pos++];
+                c = c == 'n' ? '\n' : c == 't' ? '\t' : c;
+            }
+            value += c;
+        }
+        return expect('"');
+    }
+
+    bool readNumber(double& value) {
+        skipSpace();
+        const char* begin = m_text.c_str() + m_pos;
+        char* end = nullptr;
+        value = std::strtod(begin, &end);
+        if (end == begin) {
+            return false;
+        }
+        m_pos += static_cast<size_t>(end - begin);
+        return true;
+    }
+
+    /// Skip a value of any type
+    bool skipValue() {
+        skipSpace();
+        if (m_pos >= m_text.size()) {
+            return false;
+        }
+
+        std::string text;
+        double number = 0.0;
+        switch (m_text[m_pos]) {
+            case '"':
+                return readString(text);
+            case '{':
+                m_pos++;
+                if (expect('}')) {
+                    return true;
+                }
+                do {
+                    if (!readString(text) || !expect(':') || !skipValue()) {
+                        return false;
+                    }
+                } while (next('}'));
+                return !m_failed;
+            case '[':
+                m_pos++;
+                if (expect(']')) {
+                    return true;
+                }
+                do {
+                    if (!skipValue()) {
+                        return false;
+                    }
+                } while (next(']'));
+                return !m_failed;
+            case 't':
+            case 'f':
+            case 'n':
+                while (m_pos < m_text.size() && std::isalpha(static_cast<unsigned char>(m_text[m_pos]))) {
+                    m_pos++;
+                }
+                return true;
+            default:
+                return readNumber(number);
+        }
+    }
+
+    [[nodiscard]] bool failed() const { return m_failed; }
+
+private:
+    void skipSpace() {
+        while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) {
+            m_pos++;
+        }
+    }
+
+    std::string m_text;
+    size_t m_pos = 0;
+    bool m_failed = false;
+};
+
+bool readMachine(JsonReader& reader, BenchmarkMachine& machine) {
+    if (!reader.expect('{')) {
+        return false;
+    }
+    if (reader.expect('}')) {
+        return true;
+    }
+
+    std::string key;
+    do {
+        if (!reader.readString(key) || !reader.expect(':')) {
+            return false;
+        }
+        double number = 0.0;
+        bool ok = true;
+        if (key == "hardware_threads") {
+            ok = reader.readNumber(number);
+            machine.hardwareThreads = static_cast<uint32_t>(number);
+        } else if (key == "compiler") {
+            ok = reader.readString(machine.compiler);
+        } else if (key == "build_type") {
+            ok = reader.readString(machine.buildType);
+        } else if (key == "gpu") {
+            ok = reader.readString(machine.gpu);
+        } else {
+            ok = reader.skipValue();
+        }
+        if (!ok) {
+            return false;
+        }
+    } while (reader.next('}'));
+    return !reader.failed();
+}
+
+bool readResult(JsonReader& reader, BenchmarkResult& result) {
+    if (!reader.expect('{')) {
+        return false;
+    }
+    if (reader.expect('}')) {
+        return true;
+    }
+
+    std::string key;
+    do {
+        if (!reader.readString(key) || !reader.expect(':')) {
+            return false;
+        }
+        double number = 0.0;
+        bool ok = true;
+        if (key == "name") {
+            ok = reader.readString(result.name);
+        } else if (key == "metrics") {
+            ok = reader.expect('{');
+            if (ok && !reader.expect('}')) {
+                std::string metric;
+                do {
+                    ok = reader.readString(metric) && reader.expect(':') && reader.readNumber(number);
+                    result.metrics[metric] = number;
+                } while (ok && reader.next('}'));
+            }
+        } else if (key == "median_ns" || key == "min_ns" || key == "p90_ns" || key == "samples" ||
+                   key == "iterations" || key == "items_per_second") {
+            ok = reader.readNumber(number);
+            if (key == "median_ns") {
+                result.medianNs = number;
+            } else if (key == "min_ns") {
+                result.minNs = number;
+            } else if (key == "p90_ns") {
+                result.p90Ns = number;
+            } else if (key == "samples") {
+                result.samples = static_cast<uint32_t>(number);
+            } else if (key == "iterations") {
+                result.iterations = static_cast<uint64_t>(number);
+            } else {
+                result.itemsPerSecond = number;
+            }
+        } else {
+            ok = reader.skipValue();
+        }
+        if (!ok) {
+            return false;
+        }
+    } while (reader.next('}'));
+    return !reader.failed();
+}
+
+std::string formatDuration(double nanoseconds) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2);
+    if (nanoseconds >= 1e9) {
+        text << nanoseconds / 1e9 << " s";
+    } else if (nanoseconds >= 1e6) {
+        text << nanoseconds / 1e6 << " ms";
+    } else if (nanoseconds >= 1e3) {
+        text << nanoseconds / 1e3 << " us";
+    } else {
+        text << nanoseconds << " ns";
+    }
+    return text.str();
+}
+
+} // namespace
+
+void Benchmark::run(const std::function<void()>& body) {
+    // Engine code reports progress on std::cout; keep it out of the timed loops
+    std::streambuf* output = std::cout.rdbuf(nullptr);
+
+    // Warm caches, allocators and lazily created state
+    const auto warmupStart = Clock::now();
+    do {
+        body();
+    } while (secondsSince(warmupStart) < m_config.warmupSeconds);
+
+    // Double the iteration count until one sample is long enough to time reliably
+    uint64_t iterations = 1;
+    for (;;) {
+        const auto start = Clock::now();
+        for (uint64_t i = 0; i < iterations; i++) {
+            body();
+        }
+        const double elapsed = secondsSince(start);
+        if (elapsed >= m_config.minSampleSeconds) {
+            break;
+        }
+        const double scale = elapsed > 0.0 ? m_config.minSampleSeconds / elapsed * 1.2 : 10.0;
+        iterations = std::max(iterations + 1, static_cast<uint64_t>(static_cast<double>(iterations) * std::min(scale, 10.0)));
+    }
+
+    std::vector<double> samples(std::max(m_config.samples, 1u));
+    for (double& sample : samples) {
+        const auto start = Clock::now();
+        for (uint64_t i = 0; i < iterations; i++) {
+            body();
+        }
+        sample = secondsSince(start) * 1e9 / static_cast<double>(iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    std::cout.rdbuf(output);
+    std::cout.clear();
+
+    m_result.samples = static_cast<uint32_t>(samples.size());
+    m_result.iterations = iterations;
+    m_result.minNs = samples.front();
+    m_result.medianNs = samples[samples.size() / 2];
+    m_result.p90Ns = samples[std::min(samples.size() - 1, samples.size() * 9 / 10)];
+    m_result.itemsPerSecond = m_itemsPerRun > 0.0 && m_result.medianNs > 0.0 ? m_itemsPerRun * 1e9 / m_result.medianNs : 0.0;
+    m_ran = true;
+}
+
+void Benchmark::skip(const std::string& reason) {
+    m_skipReason = reason;
+    std::cout << "  skipped: " << reason << "\n";
+}
+
+void BenchmarkRunner::add(const std::string& name, Function function) {
+    m_entries.push_back({name, std::move(function)});
+}
+
+size_t BenchmarkRunner::run(const BenchmarkConfig& config) {
+    m_results.clear();
+
+    for (const Entry& entry : m_entries) {
+        if (!config.filter.empty() && entry.name.find(config.filter) == std::string::npos) {
+            continue;
+        }
+
+        std::cout << entry.name << "\n";
+        BenchmarkResult result;
+        result.name = entry.name;
+        Benchmark benchmark(config, result);
+        entry.function(benchmark);
+
+        if (!benchmark.wasRun()) {
+            if (!benchmark.wasSkipped()) {
+                std::cerr << "  Benchmark did not call run()\n";
+            }
+            continue;
+        }
+
+        std::cout << "  median " << formatDuration(result.medianNs) << ", min " << formatDuration(result.minNs)
+                  << ", p90 " << formatDuration(result.p90Ns);
+        if (result.itemsPerSecond > 0.0) {
+            std::cout << ", " << std::fixed << std::setprecision(2) << result.itemsPerSecond / 1e6 << " M items/s"
+                      << std::defaultfloat;
+        }
+        for (const auto& [metric, value] : result.metrics) {
+            std::cout << ", " << metric << " " << value;
+        }
+        std::cout << "\n";
+
+        m_results.push_back(std::move(result));
+    }
+
+    return m_results.size();
+}
+
+bool writeBenchmarkResults(const std::filesystem::path& path, const BenchmarkMachine& machine,
+                           const std::vector<BenchmarkResult>& results) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open benchmark output: " << path << "\n";
+        return false;
+    }
+
+    file << std::setprecision(10);
+    file << "{\n";
+    file << "  \"version\": 1,\n";
+    file << "  \"machine\": {\n";
+    file << "    \"hardware_threads\": " << machine.hardwareThreads << ",\n";
+    file << "    \"compiler\": \"" << escapeJson(machine.compiler) << "\",\n";
+    file << "    \"build_type\": \"" << escapeJson(machine.buildType) << "\",\n";
+    file << "    \"gpu\": \"" << escapeJson(machine.gpu) << "\"\n";
+    file << "  },\n";
+    file << "  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult& result = results[i];
+        file << (i == 0 ? "\n" : ",\n");
+        file << "    {\n";
+        file << "      \"name\": \"" << escapeJson(result.name) << "\",\n";
+        file << "      \"median_ns\": " << result.medianNs << ",\n";
+        file << "      \"min_ns\": " << result.minNs << ",\n";
+        file << "      \"p90_ns\": " << result.p90Ns << ",\n";
+        file << "      \"samples\": " << result.samples << ",\n";
+        file << "      \"iterations\": " << result.iterations << ",\n";
+        file << "      \"items_per_second\": " << result.itemsPerSecond << ",\n";
+        file << "      \"metrics\": {";
+        bool first = true;
+        for (const auto& [metric, value] : result.metrics) {
+            file << (first ? "" : ", ") << "\"" << escapeJson(metric) << "\": " << value;
+            first = false;
+        }
+        file << "}\n";
+        file << "    }";
+    }
+
+    file << "\n  ]\n}\n";
+    return static_cast<bool>(file);
+}
+
+bool readBenchmarkResults(const std::filesystem::path& path, BenchmarkMachine& machine,
+                          std::vector<BenchmarkResult>& results) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open benchmark results: " << path << "\n";
+        return false;
+    }
+
+    std::stringstream text;
+    text << file.rdbuf();
+    JsonReader reader(text.str());
+    results.clear();
+
+    bool ok = reader.expect('{');
+    if (ok && !reader.expect('}')) {
+        std::string key;
+        do {
+            ok = reader.readString(key) && reader.expect(':');
+            if (!ok) {
+                break;
+            }
+            if (key == "machine") {
+                ok = readMachine(reader, machine);
+            } else if (key == "benchmarks") {
+                ok = reader.expect('[');
+                if (ok && !reader.expect(']')) {
+                    do {
+                        BenchmarkResult result;
+                        ok = readResult(reader, result);
+                        results.push_back(std::move(result));
+                    } while (ok && reader.next(']'));
+                }
+            } else {
+                ok = reader.skipValue();
+            }
+        } while (ok && reader.next('}'));
+    }
+
+    if (!ok || reader.failed()) {
+        std::cerr << "Failed to parse benchmark results: " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace ct
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ct {
+
+/// Sampling settings shared by every benchmark in a run
+struct BenchmarkConfig {
+    uint32_t samples = 15;              // Timed samples per benchmark; the median is reported
+    double minSampleSeconds = 0.02;     // Each sample repeats the body until it runs at least this long
+    double warmupSeconds = 0.05;        // Untimed runs before calibration
+    std::string filter;                 // Run only benchmarks whose name contains this
+};
+
+/// Timing of one benchmark, in nanoseconds per run of its body
+struct BenchmarkResult {
+    std::string name;
+    double medianNs = 0.0;
+    double minNs = 0.0;
+    double p90Ns = 0.0;
+    uint32_t samples = 0;
+    uint64_t iterations = 0;                    // Body runs per sample
+    double itemsPerSecond = 0.0;                // From the median (0 if the benchmark has no item count)
+    std::map<std::string, double> metrics;      // Deterministic counters; lower is better (e.g. barriers, bytes)
+};
+
+/// Description of the machine a result file was recorded on
+struct BenchmarkMachine {
+    uint32_t hardwareThreads = 0;
+    std::string compiler;
+    std::string buildType;
+    std::string gpu;                    // Empty if no scene benchmark ran
+};
+
+/// Handed to each benchmark; everything outside run() is setup and is not timed
+class Benchmark {
+public:
+    Benchmark(const BenchmarkConfig& config, BenchmarkResult& result) : m_config(config), m_result(result) {}
+
+    /// Time a body: warm up, pick an iteration count that fills a sample, then take the samples
+    void run(const std::function<void()>& body);
+
+    /// Set how many items one run of the body processes (reported as items per second)
+    void setItemsPerRun(double items) { m_itemsPerRun = items; }
+
+    /// Record a deterministic counter that the comparison tool checks alongside time
+    void setMetric(const std::string& name, double value) { m_result.metrics[name] = value; }
+
+    /// Skip the benchmark with a reason (e.g. no Vulkan device)
+    void skip(const std::string& reason);
+
+    [[nodiscard]] bool wasRun() const { return m_ran; }
+    [[nodiscard]] bool wasSkipped() const { return !m_skipReason.empty(); }
+
+private:
+    const BenchmarkConfig& m_config;
+    BenchmarkResult& m_result;
+    double m_itemsPerRun = 0.0;
+    std::string m_skipReason;
+    bool m_ran = false;
+};
+
+/// Registry and driver for the benchmark suite
+class BenchmarkRunner {
+public:
+    using Function = std::function<void(Benchmark&)>;
+
+    /// Register a benchmark ("group/name")
+    void add(const std::string& name, Function function);
+
+    /// Run every registered benchmark that matches the filter, printing one line each
+    /// @return Number of benchmarks that produced a result
+    size_t run(const BenchmarkConfig& config);
+
+    [[nodiscard]] const std::vector<BenchmarkResult>& getResults() const { return m_results; }
+
+    [[nodiscard]] BenchmarkMachine& getMachine() { return m_machine; }
+
+private:
+    struct Entry {
+        std::string name;
+        Function function;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<BenchmarkResult> m_results;
+    BenchmarkMachine m_machine;
+};
+
+/// Write results as JSON
+/// @return true if the file was written
+bool writeBenchmarkResults(const std::filesystem::path& path, const BenchmarkMachine& machine,
+                           const std::vector<BenchmarkResult>& results);
+
+/// Read a file written by writeBenchmarkResults()
+/// @return true if the file was parsed
+bool readBenchmarkResults(const std::filesystem::path& path, BenchmarkMachine& machine,
+                          std::vector<BenchmarkResult>& results);
+
+// Suites, one per engine area
+void registerCoreBenchmarks(BenchmarkRunner& runner);
+void registerEcsBenchmarks(BenchmarkRunner& runner);
+void registerImageBenchmarks(BenchmarkRunner& runner);
+void registerSceneBenchmarks(BenchmarkRunner& runner);
+
+/// Destroy the Vulkan device shared by the scene benchmarks
+void releaseSceneBenchmarks();
+
+/// Keep a value alive so the optimizer cannot drop the computation producing it
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+} // namespace ct
@@ -0,0 +1,81 @@
+#include "benchmarks/benchmark.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Runs the micro-benchmarks and headless scenes and writes the results as JSON.
+//
+// Usage: benchmarks [--filter text] [--output results.json] [--samples N] [--min-time seconds]
+//
+// Compare two result files with BenchCompare. Scene benchmarks run on the Vulkan device whose
+// name contains CT_BENCHMARK_DEVICE (default "llvmpipe", so results do not depend on the GPU).
+
+#ifndef CT_BENCHMARK_BUILD_TYPE
+#define CT_BENCHMARK_BUILD_TYPE "unknown"
+#endif
+
+namespace {
+
+std::string getCompiler() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ct::BenchmarkConfig config;
+    std::string output = "benchmark_results.json";
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) {
+            config.filter = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            output = argv[++i];
+        } else if (arg == "--samples" && hasValue) {
+            config.samples = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--min-time" && hasValue) {
+            config.minSampleSeconds = std::strtod(argv[++i], nullptr);
+        } else {
+            std::cerr << "Usage: benchmarks [--filter text] [--output results.json] [--samples N] [--min-time seconds]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    ct::BenchmarkRunner runner;
+    ct::registerCoreBenchmarks(runner);
+    ct::registerEcsBenchmarks(runner);
+    ct::registerImageBenchmarks(runner);
+    ct::registerSceneBenchmarks(runner);
+
+    ct::BenchmarkMachine& machine = runner.getMachine();
+    machine.hardwareThreads = std::thread::hardware_concurrency();
+    machine.compiler = getCompiler();
+    machine.buildType = CT_BENCHMARK_BUILD_TYPE;
+
+    const size_t count = runner.run(config);
+    ct::releaseSceneBenchmarks();
+
+    if (count == 0) {
+        std::cerr << "No benchmarks ran\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!ct::writeBenchmarkResults(output, machine, runner.getResults())) {
+        return EXIT_FAILURE;
+    }
+
+    std::cout << count << " benchmarks written to " << output << "\n";
+    return EXIT_SUCCESS;
+}
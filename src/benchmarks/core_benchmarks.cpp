@@ -0,0 +1,152 @@
+#include "benchmarks/benchmark.h"
+#include "core/job_system.h"
+#include "core/spsc_ring.h"
+#include "rendering/staging_buffer_pool.h"
+
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace ct {
+
+namespace {
+
+constexpr uint32_t kStagingSlots = 64;
+constexpr size_t kStagingSlotBytes = 256 * 256 * sizeof(uint16_t);    // One pyramid tile
+
+/// Worker pool shared by every benchmark that needs one
+JobSystem& getJobSystem() {
+    static JobSystem jobs;
+    if (jobs.getThreadCount() == 0) {
+        jobs.initialize();
+    }
+    return jobs;
+}
+
+void registerAllocatorBenchmarks(BenchmarkRunner& runner) {
+    runner.add("allocator/staging_acquire_release", [](Benchmark& benchmark) {
+        StagingBufferPool pool;
+        pool.initialize(kStagingSlotBytes, kStagingSlots);
+
+        std::vector<uint32_t> slots(kStagingSlots);
+        benchmark.setItemsPerRun(kStagingSlots);
+        benchmark.run([&] {
+            for (uint32_t& slot : slots) {
+                slot = pool.tryAcquire();
+            }
+            for (uint32_t slot : slots) {
+                pool.release(slot);
+            }
+        });
+    });
+
+    // Decode workers racing for slots, as in the tile streamer
+    runner.add("allocator/staging_contended", [](Benchmark& benchmark) {
+        JobSystem& jobs = getJobSystem();
+        StagingBufferPool pool;
+        pool.initialize(kStagingSlotBytes, kStagingSlots);
+
+        constexpr size_t kCycles = 4096;
+        benchmark.setItemsPerRun(kCycles);
+        benchmark.run([&] {
+            jobs.parallelFor(kCycles, 64, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    const uint32_t slot = pool.acquire();
+                    static_cast<uint8_t*>(pool.getSlotData(slot))[0] = static_cast<uint8_t>(i);
+                    pool.release(slot);
+                }
+            });
+        });
+    });
+
+    runner.add("allocator/spsc_ring_transfer", [](Benchmark& benchmark) {
+        constexpr uint64_t kItems = 1 << 20;
+        SpscRing<uint64_t> ring;
+        ring.initialize(4096);
+
+        benchmark.setItemsPerRun(kItems);
+        benchmark.run([&] {
+            std::thread producer([&ring] {
+                for (uint64_t i = 0; i < kItems;) {
+                    if (ring.push(i)) {
+                        i++;
+                    }
+                }
+            });
+
+            uint64_t sum = 0;
+            uint64_t value = 0;
+            for (uint64_t received = 0; received < kItems;) {
+                if (ring.pop(value)) {
+                    sum += value;
+                    received++;
+                }
+            }
+            producer.join();
+            doNotOptimize(sum);
+        });
+    });
+}
+
+void registerJobBenchmarks(BenchmarkRunner& runner) {
+    runner.add("jobs/submit_wait", [](Benchmark& benchmark) {
+        JobSystem& jobs = getJobSystem();
+        constexpr size_t kJobs = 10000;
+        std::atomic<size_t> counter{0};
+
+        benchmark.setItemsPerRun(kJobs);
+        benchmark.run([&] {
+            for (size_t i = 0; i < kJobs; i++) {
+                jobs.submit([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+            }
+            jobs.waitIdle();
+        });
+        doNotOptimize(counter.load());
+    });
+
+    // Small batches: dominated by scheduling overhead
+    runner.add("jobs/parallel_for_fine", [](Benchmark& benchmark) {
+        JobSystem& jobs = getJobSystem();
+        constexpr size_t kCount = 1 << 20;
+        std::vector<float> values(kCount, 1.0f);
+
+        benchmark.setItemsPerRun(kCount);
+        benchmark.run([&] {
+            jobs.parallelFor(kCount, 256, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    values[i] = values[i] * 0.5f + 1.0f;
+                }
+            });
+        });
+        doNotOptimize(values[kCount / 2]);
+    });
+
+    // Even split: dominated by memory bandwidth
+    runner.add("jobs/parallel_for_coarse", [](Benchmark& benchmark) {
+        JobSystem& jobs = getJobSystem();
+        constexpr size_t kCount = 1 << 24;
+        std::vector<float> x(kCount, 1.0f);
+        std::vector<float> y(kCount, 2.0f);
+
+        benchmark.setItemsPerRun(kCount);
+        benchmark.run([&] {
+            jobs.parallelFor(kCount, 0, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    y[i] = 0.5f * x[i] + y[i];
+                }
+            });
+        });
+        doNotOptimize(y[kCount / 2]);
+    });
+}
+
+} // namespace
+
+void registerCoreBenchmarks(BenchmarkRunner& runner) {
+    registerAllocatorBenchmarks(runner);
+    registerJobBenchmarks(runner);
+}
+
+} // namespace ct
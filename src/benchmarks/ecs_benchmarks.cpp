@@ -0,0 +1,129 @@
+#include "benchmarks/benchmark.h"
+#include "ecs/entity_manager.h"
+
+#include <glm/glm.hpp>
+
+#include <random>
+#include <vector>
+
+namespace ct {
+
+namespace {
+
+constexpr size_t kEntityCount = 1'000'000;
+
+struct Position {
+    glm::vec3 value{0.0f};
+};
+
+struct Velocity {
+    glm::vec3 value{1.0f, 0.5f, 0.25f};
+};
+
+} // namespace
+
+void registerEcsBenchmarks(BenchmarkRunner& runner) {
+    runner.add("ecs/create_destroy", [](Benchmark& benchmark) {
+        constexpr size_t kCount = 100'000;
+        EntityManager entities;
+        std::vector<Entity> handles;
+
+        benchmark.setItemsPerRun(kCount);
+        benchmark.run([&] {
+            handles.clear();
+            entities.createBatch(kCount, handles);
+            for (Entity entity : handles) {
+                entities.destroy(entity);
+            }
+        });
+    });
+
+    runner.add("ecs/add_component", [](Benchmark& benchmark) {
+        constexpr size_t kCount = 100'000;
+        EntityManager entities;
+        std::vector<Entity> handles;
+        entities.createBatch(kCount, handles);
+
+        benchmark.setItemsPerRun(kCount);
+        benchmark.run([&] {
+            for (Entity entity : handles) {
+                entities.addComponent<Position>(entity);
+            }
+            for (Entity entity : handles) {
+                entities.removeComponent<Position>(entity);
+            }
+        });
+    });
+
+    // Dense iteration over one component type
+    runner.add("ecs/each", [](Benchmark& benchmark) {
+        EntityManager entities;
+        std::vector<Entity> handles;
+        entities.createBatch(kEntityCount, handles);
+        entities.getPool<Velocity>().reserve(kEntityCount);
+        for (Entity entity : handles) {
+            entities.addComponent<Velocity>(entity);
+        }
+
+        benchmark.setItemsPerRun(kEntityCount);
+        benchmark.run([&] {
+            entities.each<Velocity>([](Entity, Velocity& velocity) { velocity.value *= 0.99f; });
+        });
+        if (const Velocity* velocity = entities.getComponent<Velocity>(handles.front())) {
+            doNotOptimize(velocity->value);
+        }
+    });
+
+    // Iterate one type and look up a second through the sparse set
+    runner.add("ecs/each_join", [](Benchmark& benchmark) {
+        EntityManager entities;
+        std::vector<Entity> handles;
+        entities.createBatch(kEntityCount, handles);
+        for (Entity entity : handles) {
+            entities.addComponent<Position>(entity);
+            entities.addComponent<Velocity>(entity);
+        }
+
+        benchmark.setItemsPerRun(kEntityCount);
+        benchmark.run([&] {
+            entities.each<Velocity>([&entities](Entity entity, Velocity& velocity) {
+                if (Position* position = entities.getComponent<Position>(entity)) {
+                    position->value += velocity.value * (1.0f / 60.0f);
+                }
+            });
+        });
+        if (const Position* position = entities.getComponent<Position>(handles.back())) {
+            doNotOptimize(position->value);
+        }
+    });
+
+    runner.add("ecs/random_lookup", [](Benchmark& benchmark) {
+        constexpr size_t kLookups = 100'000;
+        EntityManager entities;
+        std::vector<Entity> handles;
+        entities.createBatch(kEntityCount, handles);
+        for (Entity entity : handles) {
+            entities.addComponent<Position>(entity);
+        }
+
+        std::mt19937 random(42);
+        std::vector<Entity> order(kLookups);
+        std::uniform_int_distribution<size_t> pick(0, handles.size() - 1);
+        for (Entity& entity : order) {
+            entity = handles[pick(random)];
+        }
+
+        benchmark.setItemsPerRun(kLookups);
+        benchmark.run([&] {
+            float sum = 0.0f;
+            for (Entity entity : order) {
+                if (const Position* position = entities.getComponent<Position>(entity)) {
+                    sum += position->value.x;
+                }
+            }
+            doNotOptimize(sum);
+        });
+    });
+}
+
+} // namespace ct
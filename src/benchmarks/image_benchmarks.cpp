@@ -0,0 +1,166 @@
+#include "benchmarks/benchmark.h"
+#include "rendering/multiplex_image/cell_feature_table.h"
+#include "rendering/multiplex_image/cell_quantifier.h"
+#include "rendering/multiplex_image/image_pyramid.h"
+#include "rendering/multiplex_image/segmentation_mask.h"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace ct {
+
+namespace {
+
+constexpr uint32_t kImageSize = 4096;
+constexpr uint32_t kChannelCount = 4;
+constexpr uint32_t kCellSpacing = 16;       // One synthetic cell per 16x16 block
+
+/// Procedural multiplex image; a small marker file on disk stands in for the TIFF so the
+/// pyramid has something to fingerprint
+class SyntheticImage : public ImageSource {
+public:
+    explicit SyntheticImage(std::filesystem::path path) : m_path(std::move(path)) {
+        std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+        file << "ct benchmark image " << kImageSize << "x" << kImageSize << "x" << kChannelCount << "\n";
+    }
+
+    [[nodiscard]] uint32_t getWidth() const override { return kImageSize; }
+    [[nodiscard]] uint32_t getHeight() const override { return kImageSize; }
+    [[nodiscard]] uint32_t getChannelCount() const override { return kChannelCount; }
+    [[nodiscard]] std::filesystem::path getPath() const override { return m_path; }
+
+    bool readRegion(uint32_t channel, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                    uint16_t* destination, size_t rowStride) const override {
+        for (uint32_t row = 0; row < height; row++) {
+            uint16_t* out = destination + row * rowStride;
+            for (uint32_t column = 0; column < width; column++) {
+                out[column] = static_cast<uint16_t>(((x + column) * 7 + (y + row) * 13 + channel * 1021) & 0xFFFF);
+            }
+        }
+        return true;
+    }
+
+private:
+    std::filesystem::path m_path;
+};
+
+/// Grid of square cells with a one-pixel background border
+class SyntheticLabels : public LabelSource {
+public:
+    [[nodiscard]] uint32_t getWidth() const override { return kImageSize; }
+    [[nodiscard]] uint32_t getHeight() const override { return kImageSize; }
+
+    bool readRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t* destination,
+                    size_t rowStride) const override {
+        constexpr uint32_t kCellsPerRow = kImageSize / kCellSpacing;
+        for (uint32_t row = 0; row < height; row++) {
+            const uint32_t py = y + row;
+            for (uint32_t column = 0; column < width; column++) {
+                const uint32_t px = x + column;
+                const bool border = px % kCellSpacing == 0 || py % kCellSpacing == 0;
+                destination[row * rowStride + column] =
+                    border ? 0 : (py / kCellSpacing) * kCellsPerRow + px / kCellSpacing + 1;
+            }
+        }
+        return true;
+    }
+};
+
+std::filesystem::path getScratchPath(const char* name) {
+    return std::filesystem::temp_directory_path() / name;
+}
+
+} // namespace
+
+void registerImageBenchmarks(BenchmarkRunner& runner) {
+    // Tile decode from the pyramid sidecar, the path the tile streamer takes for levels >= 1
+    runner.add("tiff/pyramid_read_tile", [](Benchmark& benchmark) {
+        SyntheticImage image(getScratchPath("ct_benchmark_image.raw"));
+        ImagePyramid pyramid;
+        ImagePyramidConfig config;
+        config.sidecarPath = getScratchPath("ct_benchmark_image.ctpyr");
+        if (!pyramid.open(image, config)) {
+            benchmark.skip("pyramid could not be built");
+            return;
+        }
+
+        const uint32_t tileSize = pyramid.getTileSize();
+        const PyramidLevel& level = pyramid.getLevel(1);
+        std::vector<uint16_t> tile(static_cast<size_t>(tileSize) * tileSize);
+        uint32_t next = 0;
+
+        benchmark.setItemsPerRun(static_cast<double>(tile.size()));
+        benchmark.run([&] {
+            const uint32_t index = next++ % (level.tilesX * level.tilesY);
+            pyramid.readTile(1, index % kChannelCount, index % level.tilesX, index / level.tilesX, tile.data());
+            doNotOptimize(tile[0]);
+        });
+
+        pyramid.close();
+        std::filesystem::remove(config.sidecarPath);
+        std::filesystem::remove(image.getPath());
+    });
+
+    runner.add("tiff/downsample2x2", [](Benchmark& benchmark) {
+        constexpr uint32_t kOutputSize = 1024;
+        std::vector<uint16_t> source(static_cast<size_t>(kOutputSize) * kOutputSize * 4);
+        std::vector<uint16_t> destination(static_cast<size_t>(kOutputSize) * kOutputSize);
+        for (size_t i = 0; i < source.size(); i++) {
+            source[i] = static_cast<uint16_t>(i * 2654435761u >> 16);
+        }
+
+        benchmark.setItemsPerRun(static_cast<double>(destination.size()));
+        benchmark.run([&] {
+            ImagePyramid::downsample2x2(source.data(), kOutputSize * 2, destination.data(), kOutputSize,
+                                        kOutputSize, kOutputSize);
+            doNotOptimize(destination[0]);
+        });
+    });
+
+    runner.add("quantify/cells", [](Benchmark& benchmark) {
+        SyntheticImage image(getScratchPath("ct_benchmark_quantify.raw"));
+        SegmentationMask mask;
+        if (!mask.build(SyntheticLabels{})) {
+            benchmark.skip("mask could not be built");
+            return;
+        }
+
+        const CellQuantifier quantifier;
+        CellFeatureTable table;
+        benchmark.setItemsPerRun(static_cast<double>(kImageSize) * kImageSize * kChannelCount);
+        benchmark.run([&] {
+            quantifier.quantify(mask, image, table);
+        });
+
+        std::filesystem::remove(image.getPath());
+    });
+
+    runner.add("mask/pick_cell", [](Benchmark& benchmark) {
+        SegmentationMask mask;
+        if (!mask.build(SyntheticLabels{})) {
+            benchmark.skip("mask could not be built");
+            return;
+        }
+
+        constexpr size_t kPicks = 100'000;
+        std::mt19937 random(7);
+        std::uniform_int_distribution<uint32_t> coordinate(0, kImageSize - 1);
+        std::vector<std::pair<uint32_t, uint32_t>> points(kPicks);
+        for (auto& point : points) {
+            point = {coordinate(random), coordinate(random)};
+        }
+
+        benchmark.setItemsPerRun(kPicks);
+        benchmark.run([&] {
+            uint32_t sum = 0;
+            for (const auto& [x, y] : points) {
+                sum += mask.pickCell(x, y);
+            }
+            doNotOptimize(sum);
+        });
+    });
+}
+
+} // namespace ct
@@ -0,0 +1,292 @@
+#include "benchmarks/benchmark.h"
+#include "rendering/render_graph.h"
+#include "rendering/vulkan_context.h"
+
+#include <array>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace ct {
+
+namespace {
+
+// Scenes are made of transfer commands only (clears, blits, copies) until the pipeline layer
+// exists; they exercise the render graph's scheduling, barriers and memory as a real frame would.
+
+constexpr uint32_t kSceneSize = 2048;
+
+std::unique_ptr<VulkanContext> g_context;
+bool g_contextAttempted = false;
+
+/// Create the headless device on first use
+/// Runs on lavapipe unless CT_BENCHMARK_DEVICE names another device, so numbers are comparable
+/// between machines with different GPUs.
+VulkanContext* getContext(BenchmarkMachine& machine) {
+    if (g_contextAttempted) {
+        return g_context.get();
+    }
+    g_contextAttempted = true;
+
+    VulkanContextConfig config;
+    config.applicationName = "Cellular Threshold Benchmarks";
+    config.enableValidation = false;
+    const char* device = std::getenv("CT_BENCHMARK_DEVICE");
+    config.preferredDevice = device ? device : "llvmpipe";
+
+    auto context = std::make_unique<VulkanContext>();
+    if (!context->initializeHeadless(config)) {
+        return nullptr;
+    }
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(context->getPhysicalDevice(), &properties);
+    machine.gpu = properties.deviceName;
+
+    g_context = std::move(context);
+    return g_context.get();
+}
+
+VkImageSubresourceRange getColorRange() {
+    return {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+}
+
+VkImageSubresourceLayers getColorLayers() {
+    return {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+}
+
+void clearImage(VkCommandBuffer commandBuffer, VkImage image, float value) {
+    VkClearColorValue color{};
+    color.float32[0] = value;
+    color.float32[1] = value;
+    color.float32[2] = value;
+    color.float32[3] = 1.0f;
+    const VkImageSubresourceRange range = getColorRange();
+    vkCmdClearColorImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &color, 1, &range);
+}
+
+void blitImage(VkCommandBuffer commandBuffer, VkImage source, VkOffset3D sourceMin, VkOffset3D sourceMax,
+               VkImage destination, VkOffset3D destinationMin, VkOffset3D destinationMax) {
+    VkImageBlit blit{};
+    blit.srcSubresource = getColorLayers();
+    blit.srcOffsets[0] = sourceMin;
+    blit.srcOffsets[1] = sourceMax;
+    blit.dstSubresource = getColorLayers();
+    blit.dstOffsets[0] = destinationMin;
+    blit.dstOffsets[1] = destinationMax;
+    vkCmdBlitImage(commandBuffer, source, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, destination,
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+}
+
+void copyImage(VkCommandBuffer commandBuffer, VkImage source, VkImage destination, VkOffset3D destinationOffset,
+               uint32_t width, uint32_t height) {
+    VkImageCopy copy{};
+    copy.srcSubresource = getColorLayers();
+    copy.dstSubresource = getColorLayers();
+    copy.dstOffset = destinationOffset;
+    copy.extent = {width, height, 1};
+    vkCmdCopyImage(commandBuffer, source, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, destination,
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+}
+
+/// Multiplex compositor: upload channels, composite them, overlay cell outlines
+/// The histogram pass feeds nothing and is culled.
+void buildCompositeScene(RenderGraph& scene) {
+    constexpr uint32_t kChannels = 8;
+    constexpr int32_t kSize = static_cast<int32_t>(kSceneSize);
+    constexpr int32_t kStrip = kSize / static_cast<int32_t>(kChannels);
+    constexpr int32_t kOverlayWidth = kSize / 4;
+
+    std::array<RenderResource, kChannels> channels;
+    for (uint32_t i = 0; i < kChannels; i++) {
+        channels[i] = scene.createImage("channel" + std::to_string(i), {VK_FORMAT_R16_UNORM, kSceneSize, kSceneSize});
+    }
+    const RenderResource composite =
+        scene.createImage("composite", {VK_FORMAT_R16G16B16A16_SFLOAT, kSceneSize, kSceneSize});
+    const RenderResource outlines =
+        scene.createImage("outlines", {VK_FORMAT_R8G8B8A8_UNORM, kSceneSize / 4, kSceneSize});
+    const RenderResource display = scene.createImage("display", {VK_FORMAT_R8G8B8A8_UNORM, kSceneSize, kSceneSize});
+    const RenderResource histogram = scene.createImage("histogram", {VK_FORMAT_R16G16B16A16_SFLOAT, 256, 1});
+    scene.markOutput(display);
+
+    for (uint32_t i = 0; i < kChannels; i++) {
+        const RenderResource channel = channels[i];
+        scene.addPass(
+            "upload channel " + std::to_string(i), PassQueue::Graphics,
+            [channel](RenderPassBuilder& builder) { builder.write(channel, ResourceUsage::TransferDestination); },
+            [channel, i](VkCommandBuffer commandBuffer, const RenderGraph& graph) {
+                clearImage(commandBuffer, graph.getImage(channel), static_cast<float>(i + 1) / kChannels);
+            });
+    }
+
+    // Each channel lands in its own strip so the blits do not overlap
+    scene.addPass(
+        "composite", PassQueue::Graphics,
+        [&channels, composite](RenderPassBuilder& builder) {
+            for (RenderResource channel : channels) {
+                builder.read(channel, ResourceUsage::TransferSource);
+            }
+            builder.write(composite, ResourceUsage::TransferDestination);
+        },
+        [channels, composite](VkCommandBuffer commandBuffer, const RenderGraph& graph) {
+            for (int32_t i = 0; i < static_cast<int32_t>(kChannels); i++) {
+                blitImage(commandBuffer, graph.getImage(channels[static_cast<size_t>(i)]), {0, 0, 0}, {kSize, kSize, 1},
+                          graph.getImage(composite), {0, i * kStrip, 0}, {kSize, (i + 1) * kStrip, 1});
+            }
+        });
+
+    scene.addPass(
+        "outlines", PassQueue::AsyncCompute,
+        [outlines](RenderPassBuilder& builder) { builder.write(outlines, ResourceUsage::TransferDestination); },
+        [outlines](VkCommandBuffer commandBuffer, const RenderGraph& graph) {
+            clearImage(commandBuffer, graph.getImage(outlines), 0.25f);
+        });
+
+    scene.addPass(
+        "overlay", PassQueue::Graphics,
+        [composite, outlines, display](RenderPassBuilder& builder) {
+            builder.read(composite, ResourceUsage::TransferSource);
+            builder.read(outlines, ResourceUsage::TransferSource);
+            builder.write(display, ResourceUsage::TransferDestination);
+        },
+        [composite, outlines, display](VkCommandBuffer commandBuffer, const RenderGraph& graph) {
+            blitImage(commandBuffer, graph.getImage(composite), {0, 0, 0}, {kSize, kSize, 1}, graph.getImage(display),
+                      {0, 0, 0}, {kSize - kOverlayWidth, kSize, 1});
+            copyImage(commandBuffer, graph.getImage(outlines), graph.getImage(display), {kSize - kOverlayWidth, 0, 0},
+                      kSceneSize / 4, kSceneSize);
+        });
+
+    scene.addPass(
+        "histogram", PassQueue::AsyncCompute,
+        [composite, histogram](RenderPassBuilder& builder) {
+            builder.read(composite, ResourceUsage::TransferSource);
+            builder.write(histogram, ResourceUsage::TransferDestination);
+        },
+        [composite, histogram](VkCommandBuffer commandBuffer, const RenderGraph& graph) {
+            copyImage(commandBuffer, graph.getImage(composite), graph.getImage(histogram), {0, 0, 0}, 256, 1);
+        });
+}
+
+/// Tile streaming: decode tiles into small staging images and place them in an atlas
+/// Staging images have disjoint lifetimes, so they all alias the same memory.
+void buildTileAtlasScene(RenderGraph& scene) {
+    constexpr uint32_t kTileSize = 256;
+    constexpr uint32_t kTilesPerRow = kSceneSize / kTileSize;
+    constexpr uint32_t kTileCount = 32;
+
+    const RenderResource atlas = scene.createImage("atlas", {VK_FORMAT_R16_UNORM, kSceneSize, kSceneSize});
+    const RenderResource display = scene.createImage("display", {VK_FORMAT_R8G8B8A8_UNORM, kSceneSize, kSceneSize});
+    scene.markOutput(display);
+
+    for (uint32_t i = 0; i < kTileCount; i++) {
+        const RenderResource tile =
+            scene.createImage("tile" + std::to_string(i), {VK_FORMAT_R16_UNORM, kTileSize, kTileSize});
+
+        scene.addPass(
+            "decode tile " + std::to_string(i), PassQueue::Graphics,
+            [tile](RenderPassBuilder& builder) { builder.write(tile, ResourceUsage::TransferDestination); },
+            [tile, i](VkCommandBuffer commandBuffer, const RenderGraph& graph) {
+                clearImage(commandBuffer, graph.getImage(tile), static_cast<float>(i) / kTileCount);
+            });
+
+        const VkOffset3D offset{static_cast<int32_t>(i % kTilesPerRow * kTileSize),
+                                static_cast<int32_t>(i / kTilesPerRow * kTileSize), 0};
+        scene.addPass(
+            "place tile " + std::to_string(i), PassQueue::Graphics,
+            [tile, atlas](RenderPassBuilder& builder) {
+                builder.read(tile, ResourceUsage::TransferSource);
+                builder.write(atlas, ResourceUsage::TransferDestination);
+            },
+            [tile, atlas, offset](VkCommandBuffer commandBuffer, const RenderGraph& graph) {
+                copyImage(commandBuffer, graph.getImage(tile), graph.getImage(atlas), offset, kTileSize, kTileSize);
+            });
+    }
+
+    scene.addPass(
+        "display", PassQueue::Graphics,
+        [atlas, display](RenderPassBuilder& builder) {
+            builder.read(atlas, ResourceUsage::TransferSource);
+            builder.write(display, ResourceUsage::TransferDestination);
+        },
+        [atlas, display](VkCommandBuffer commandBuffer, const RenderGraph& graph) {
+            constexpr int32_t kSize = static_cast<int32_t>(kSceneSize);
+            blitImage(commandBuffer, graph.getImage(atlas), {0, 0, 0}, {kSize, kSize, 1}, graph.getImage(display),
+                      {0, 0, 0}, {kSize, kSize, 1});
+        });
+}
+
+/// Register a scene twice: with every render graph optimization, and as the naive baseline
+void addScene(BenchmarkRunner& runner, const std::string& name, const std::function<void(RenderGraph&)>& build) {
+    for (const bool naive : {false, true}) {
+        runner.add(naive ? name + "_naive" : name, [&runner, build, naive](Benchmark& benchmark) {
+            VulkanContext* context = getContext(runner.getMachine());
+            if (!context) {
+                benchmark.skip("no Vulkan 1.3 device");
+                return;
+            }
+
+            RenderGraphConfig config;
+            if (naive) {
+                config.cullPasses = false;
+                config.aliasTransients = false;
+                config.minimalBarriers = false;
+                config.asyncCompute = false;
+            }
+
+            RenderGraph graph;
+            if (!graph.initialize(*context, config)) {
+                benchmark.skip("render graph could not be initialized");
+                return;
+            }
+            build(graph);
+            if (!graph.compile()) {
+                benchmark.skip("render graph could not be compiled");
+                return;
+            }
+
+            const VkDevice device = context->getDevice();
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            VkFence fence = VK_NULL_HANDLE;
+            if (vkCreateFence(device, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+                benchmark.skip("fence could not be created");
+                return;
+            }
+
+            // One frame per run, CPU recording through GPU completion
+            RenderGraphSubmitInfo submit;
+            submit.fence = fence;
+            benchmark.run([&] {
+                graph.execute(submit);
+                vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+                vkResetFences(device, 1, &fence);
+            });
+
+            const RenderGraphStats& stats = graph.getStats();
+            benchmark.setMetric("passes_executed", stats.passes - stats.culledPasses);
+            benchmark.setMetric("barriers", stats.imageBarriers + stats.bufferBarriers + stats.memoryBarriers);
+            benchmark.setMetric("full_barriers", stats.fullBarriers);
+            benchmark.setMetric("barrier_batches", stats.barrierBatches);
+            benchmark.setMetric("submits", stats.submits);
+            benchmark.setMetric("transient_bytes", static_cast<double>(stats.transientBytes));
+
+            vkDestroyFence(device, fence, nullptr);
+            graph.shutdown();
+        });
+    }
+}
+
+} // namespace
+
+void registerSceneBenchmarks(BenchmarkRunner& runner) {
+    addScene(runner, "scene/multiplex_composite", buildCompositeScene);
+    addScene(runner, "scene/tile_atlas", buildTileAtlasScene);
+}
+
+void releaseSceneBenchmarks() {
+    g_context.reset();
+    g_contextAttempted = false;
+}
+
+} // namespace ct
@@ -1,34 +1,97 @@
 #include "core/engine.h"
+#include "core/startup_graph.h"
 
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
+#include <vector>
 
 namespace ct {
 
+namespace {
+
+// Upper bound on an idle sleep, in case a wake-up is missed
+constexpr double kMaxIdleWaitSeconds = 1.0;
+
+// Simulation steps dropped after a stall instead of being replayed
+constexpr auto kMaxSimulationCatchUp = std::chrono::milliseconds(250);
+
+} // namespace
+
 Engine::~Engine() {
     shutdown();
 }
 
 bool Engine::initialize(const EngineConfig& config) {
     std::cout << "Initializing Cellular Threshold Engine...\n";
-
-    // Initialize window system
-    if (!m_window.initialize(config.window)) {
-        std::cerr << "Failed to initialize window system\n";
-        return false;
-    }
+    m_startTime = Clock::now();
+    m_firstFrameReported = false;
+    m_printStartupReport = config.printStartupReport;
 
     // Configure Vulkan context
     VulkanContextConfig vulkanConfig;
     vulkanConfig.applicationName = config.applicationName;
     vulkanConfig.enableValidation = config.enableValidation;
+    vulkanConfig.pipelineCachePath = config.pipelineCachePath;
+    std::vector<uint8_t> pipelineCacheData;
+
+    // Window system calls stay on the main thread; instance creation (layer probing, driver
+    // loading) and file reads run on workers while the window is created
+    StartupGraph startup;
+    const auto platform = startup.addStage("window system", StageThread::Main, {}, [] {
+        return Window::initializePlatform();
+    });
+    const auto pipelineCache = startup.addStage("pipeline cache read", StageThread::Worker, {}, [&] {
+        pipelineCacheData = VulkanContext::readPipelineCache(vulkanConfig.pipelineCachePath);
+        return true;
+    });
+    const auto instance = startup.addStage("vulkan instance", StageThread::Worker, {platform}, [&] {
+        return m_vulkanContext.initializeInstance(vulkanConfig);
+    });
+    const auto window = startup.addStage("window", StageThread::Main, {platform}, [&] {
+        return m_window.initialize(config.window);
+    });
+
+    // Attach input to the window callbacks
+    startup.addStage("input", StageThread::Main, {window}, [&] {
+        return m_input.initialize(m_window, config.input);
+    });
+
+    const auto device = startup.addStage("vulkan device", StageThread::Main, {instance, window, pipelineCache}, [&] {
+        return m_vulkanContext.initializeDevice(vulkanConfig, m_window, pipelineCacheData);
+    });
+
+    // Frame pacing follows the window's vsync setting
+    startup.addStage("frame pacer", StageThread::Main, {device}, [&] {
+        FramePacerConfig pacingConfig = config.framePacing;
+        pacingConfig.vsync = config.window.vsync;
+        const bool paced = m_framePacer.initialize(pacingConfig, &m_vulkanContext);
+        m_framePacer.setWaitFunction([this](double seconds) { m_window.waitEvents(seconds); });
+        return paced;
+    });
+
+    const bool started = startup.run();
+    if (m_printStartupReport) {
+        startup.printReport();
+    }
 
-    // Initialize Vulkan
-    if (!m_vulkanContext.initialize(vulkanConfig, m_window)) {
-        std::cerr << "Failed to initialize Vulkan context\n";
+    if (!started) {
+        std::cerr << "Failed to initialize engine\n";
+        m_framePacer.shutdown();
+        m_vulkanContext.shutdown();
+        m_input.shutdown();
         m_window.shutdown();
+        Window::shutdownPlatform();
         return false;
     }
 
+    m_redrawOnDemand = config.redrawOnDemand;
+    m_simulationPeriod = config.simulationTickRate > 0.0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / config.simulationTickRate))
+        : Clock::duration::zero();
+    m_nextSimulationTick = Clock::now() + m_simulationPeriod;
+    m_redrawRequested = true;
+
     m_initialized = true;
     std::cout << "Engine initialization complete.\n";
     return true;
@@ -44,12 +107,32 @@ void Engine::run() {
     m_running = true;
 
     while (m_running && !m_window.shouldClose()) {
+        // Nothing to show: skip recording and present and let the OS park the thread
+        if (m_redrawOnDemand && !isFrameNeeded()) {
+            waitForActivity();
+            continue;
+        }
+
+        m_framePacer.beginFrame();
         tick();
+
+        // Before endFrame() so the pacing sleep is not counted
+        if (!m_firstFrameReported) {
+            m_firstFrameReported = true;
+            if (m_printStartupReport) {
+                const double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - m_startTime).count();
+                std::cout << std::fixed << std::setprecision(2) << "First frame after " << elapsedMs << " ms\n"
+                          << std::defaultfloat;
+            }
+        }
+
+        m_framePacer.endFrame();
     }
 
     // Wait for GPU to finish before cleanup
     m_vulkanContext.waitIdle();
 
+    m_framePacer.printReport();
     std::cout << "Main loop ended.\n";
 }
 
@@ -62,13 +145,29 @@ void Engine::shutdown() {
     m_running = false;
 
     // Shutdown in reverse order of initialization
+    m_jobs.shutdown();
+    m_framePacer.shutdown();
     m_vulkanContext.shutdown();
+    m_input.shutdown();
     m_window.shutdown();
 
     m_initialized = false;
     std::cout << "Engine shutdown complete.\n";
 }
 
+JobSystem& Engine::getJobSystem() {
+    // Nothing on the way to the first frame needs workers, so they start when first asked for
+    if (m_jobs.getThreadCount() == 0) {
+        m_jobs.initialize();
+    }
+    return m_jobs;
+}
+
+void Engine::requestRedraw() {
+    m_redrawRequested.store(true, std::memory_order_release);
+    Window::postEmptyEvent();
+}
+
 void Engine::tick() {
     // Poll window events
     m_window.pollEvents();
@@ -79,9 +178,48 @@ void Engine::tick() {
         m_window.resetResizeFlag();
     }
 
-    // TODO: Update game logic
+    updateSimulation();
+
+    // Clear before drawing so requests made while this frame is recorded are kept
+    m_redrawRequested.store(false, std::memory_order_relaxed);
+    m_window.resetActivity();
 
     // TODO: Render frame
 }
 
+bool Engine::isFrameNeeded() const {
+    return m_animating || m_redrawRequested.load(std::memory_order_acquire) || m_window.wasResized() ||
+           m_window.hasActivity();
+}
+
+void Engine::waitForActivity() {
+    double timeout = kMaxIdleWaitSeconds;
+    if (m_simulationPeriod > Clock::duration::zero()) {
+        const double untilTick = std::chrono::duration<double>(m_nextSimulationTick - Clock::now()).count();
+        timeout = std::clamp(untilTick, 0.0, kMaxIdleWaitSeconds);
+    }
+
+    m_window.waitEvents(timeout);
+    updateSimulation();
+
+    // The idle gap is not a frame; start pacing afresh when drawing resumes
+    m_framePacer.resume();
+}
+
+void Engine::updateSimulation() {
+    if (m_simulationPeriod == Clock::duration::zero()) {
+        return;
+    }
+
+    const auto now = Clock::now();
+    if (now - m_nextSimulationTick > kMaxSimulationCatchUp) {
+        m_nextSimulationTick = now;
+    }
+
+    while (m_nextSimulationTick <= now) {
+        // TODO: Update game logic (call requestRedraw() when the visible state changes)
+        m_nextSimulationTick += m_simulationPeriod;
+    }
+}
+
 } // namespace ct
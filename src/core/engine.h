@@ -1,8 +1,14 @@
 #pragma once
 
+#include "core/frame_pacer.h"
+#include "core/input.h"
+#include "core/job_system.h"
 #include "core/window.h"
 #include "rendering/vulkan_context.h"
 
+#include <atomic>
+#include <chrono>
+#include <filesystem>
 #include <string>
 #include <memory>
 
@@ -11,8 +17,14 @@ namespace ct {
 /// Configuration for the game engine
 struct EngineConfig {
     WindowConfig window;
+    InputConfig input;
+    FramePacerConfig framePacing;  // vsync is taken from window.vsync
     std::string applicationName = "Cellular Threshold";
     bool enableValidation = true;  // Enable Vulkan validation layers
+    bool redrawOnDemand = true;    // Sleep until input or a redraw request instead of drawing unchanged frames
+    double simulationTickRate = 0.0; // Fixed simulation steps per second, which also wake an idle loop (0 = none)
+    std::filesystem::path pipelineCachePath = "pipeline_cache.bin"; // Saved Vulkan pipeline cache (empty = none)
+    bool printStartupReport = true; // Print per-stage startup timing and time to first frame
 };
 
 /// Main game engine class
@@ -27,6 +39,8 @@ public:
     Engine& operator=(const Engine&) = delete;
 
     /// Initialize all engine systems
+    /// Independent stages run concurrently (Vulkan instance creation and file reads overlap window
+    /// creation); subsystems the first frame does not need start on first use.
     /// @param config Engine configuration settings
     /// @return true if all systems initialized successfully
     bool initialize(const EngineConfig& config = {});
@@ -40,22 +54,66 @@ public:
     /// Check if the engine is currently running
     [[nodiscard]] bool isRunning() const { return m_running; }
 
+    /// Ask for a frame to be drawn, waking the loop if it is idle (safe to call from any thread)
+    void requestRedraw();
+
+    /// Draw every frame while something is animating, even without input
+    void setAnimating(bool animating) { m_animating = animating; }
+    [[nodiscard]] bool isAnimating() const { return m_animating; }
+
     /// Get the window instance
     [[nodiscard]] Window& getWindow() { return m_window; }
     [[nodiscard]] const Window& getWindow() const { return m_window; }
 
+    /// Get the input system (drain its events from one thread only)
+    [[nodiscard]] Input& getInput() { return m_input; }
+    [[nodiscard]] const Input& getInput() const { return m_input; }
+
     /// Get the Vulkan context instance
     [[nodiscard]] VulkanContext& getVulkanContext() { return m_vulkanContext; }
     [[nodiscard]] const VulkanContext& getVulkanContext() const { return m_vulkanContext; }
 
+    /// Get the worker pool, starting it on first use (main thread)
+    [[nodiscard]] JobSystem& getJobSystem();
+
+    /// Get the frame pacer
+    [[nodiscard]] FramePacer& getFramePacer() { return m_framePacer; }
+    [[nodiscard]] const FramePacer& getFramePacer() const { return m_framePacer; }
+
 private:
+    using Clock = std::chrono::steady_clock;
+
     /// Process one frame
     void tick();
 
+    /// Check whether anything changed since the last frame that needs drawing
+    [[nodiscard]] bool isFrameNeeded() const;
+
+    /// Block until input, a redraw request or the next simulation tick
+    void waitForActivity();
+
+    /// Run the simulation steps that are due
+    void updateSimulation();
+
     Window m_window;
+    Input m_input;
     VulkanContext m_vulkanContext;
+    FramePacer m_framePacer;
+    JobSystem m_jobs;
     bool m_running = false;
     bool m_initialized = false;
+
+    // Startup timing
+    Clock::time_point m_startTime{};
+    bool m_firstFrameReported = false;
+    bool m_printStartupReport = true;
+
+    // Redraw on demand
+    bool m_redrawOnDemand = true;
+    bool m_animating = false;
+    std::atomic<bool> m_redrawRequested{true};
+    Clock::duration m_simulationPeriod{};
+    Clock::time_point m_nextSimulationTick{};
 };
 
 } // namespace ct
@@ -0,0 +1,250 @@
+#include "core/frame_pacer.h"
+#include "rendering/vulkan_context.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+namespace ct {
+
+namespace {
+
+constexpr uint64_t kPresentWaitTimeoutNs = 100'000'000;
+
+const char* presentModeName(VkPresentModeKHR mode) {
+    switch (mode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR: return "IMMEDIATE";
+        case VK_PRESENT_MODE_MAILBOX_KHR: return "MAILBOX";
+        case VK_PRESENT_MODE_FIFO_KHR: return "FIFO";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO_RELAXED";
+        default: return "OTHER";
+    }
+}
+
+double toMilliseconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+FramePacer::~FramePacer() {
+    shutdown();
+}
+
+bool FramePacer::initialize(const FramePacerConfig& config, const VulkanContext* context) {
+    shutdown();
+
+    m_config = config;
+    m_config.historyFrames = std::max(m_config.historyFrames, 1u);
+    setTargetFps(config.targetFps);
+
+    if (context) {
+        m_presentMode = choosePresentMode(context->getSurfacePresentModes(), config.vsync, config.lowLatency);
+
+        if (context->isPresentWaitEnabled() && config.lowLatency) {
+            m_device = context->getDevice();
+            m_waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+                vkGetDeviceProcAddr(m_device, "vkWaitForPresentKHR"));
+        }
+    }
+
+#ifdef _WIN32
+    // Default scheduler granularity is 15.6 ms, far too coarse to sleep through a frame
+    timeBeginPeriod(1);
+#endif
+
+    m_initialized = true;
+    std::cout << "Frame pacer: " << (m_config.targetFps > 0.0 ? m_config.targetFps : 0.0) << " fps cap"
+              << (m_config.targetFps > 0.0 ? "" : " (uncapped)") << ", present mode " << presentModeName(m_presentMode)
+              << ", present wait " << (m_waitForPresent ? "on" : "off") << "\n";
+    return true;
+}
+
+void FramePacer::shutdown() {
+    if (!m_initialized) {
+        return;
+    }
+
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+
+    m_device = VK_NULL_HANDLE;
+    m_swapchain = VK_NULL_HANDLE;
+    m_waitForPresent = nullptr;
+    m_presentId = 0;
+    m_hasDeadline = false;
+    m_initialized = false;
+}
+
+void FramePacer::beginFrame() {
+    const auto waitStart = Clock::now();
+
+    // Wait for the display rather than the driver queue: the frame we are about to build
+    // will be shown right after the one we wait for, so its input is as fresh as possible
+    if (m_waitForPresent && m_swapchain != VK_NULL_HANDLE && m_presentId > m_config.maxQueuedFrames) {
+        m_waitForPresent(m_device, m_swapchain, m_presentId - m_config.maxQueuedFrames, kPresentWaitTimeoutNs);
+    }
+
+    m_frameStart = Clock::now();
+    m_frameWaitMs = toMilliseconds(m_frameStart - waitStart);
+
+    if (m_frameCount > 0 && !m_resumed) {
+        m_frameMs.push(toMilliseconds(m_frameStart - m_lastFrameStart), m_config.historyFrames);
+    }
+    m_lastFrameStart = m_frameStart;
+    m_resumed = false;
+}
+
+void FramePacer::endFrame() {
+    const auto end = Clock::now();
+    m_cpuMs.push(toMilliseconds(end - m_frameStart), m_config.historyFrames);
+
+    if (m_period > Clock::duration::zero()) {
+        Clock::time_point deadline = m_hasDeadline ? m_deadline + m_period : m_frameStart + m_period;
+
+        // After a long stall, resynchronize instead of rushing frames to catch up
+        if (deadline + m_period < end) {
+            deadline = end;
+        }
+
+        waitUntil(deadline);
+        m_deadline = deadline;
+        m_hasDeadline = true;
+    }
+
+    m_frameWaitMs += toMilliseconds(Clock::now() - end);
+    m_waitMs.push(m_frameWaitMs, m_config.historyFrames);
+    m_frameCount++;
+}
+
+void FramePacer::resume() {
+    m_hasDeadline = false;
+    m_resumed = true;
+}
+
+void FramePacer::recordGpuTime(double milliseconds) {
+    m_gpuMs.push(milliseconds, m_config.historyFrames);
+}
+
+void FramePacer::setSwapchain(VkSwapchainKHR swapchain) {
+    // Present ids are per swapchain
+    m_swapchain = swapchain;
+    m_presentId = 0;
+}
+
+uint64_t FramePacer::nextPresentId() {
+    return m_waitForPresent ? ++m_presentId : 0;
+}
+
+void FramePacer::setTargetFps(double fps) {
+    m_config.targetFps = fps;
+    m_period = fps > 0.0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps))
+        : Clock::duration::zero();
+    m_hasDeadline = false;
+}
+
+FrameTimingStats FramePacer::getStats() const {
+    FrameTimingStats stats;
+    stats.frameCount = m_frameCount;
+    stats.averageFrameMs = m_frameMs.average();
+    stats.averageCpuMs = m_cpuMs.average();
+    stats.averageGpuMs = m_gpuMs.average();
+    stats.gpuSampleCount = m_gpuMs.values.size();
+    stats.averageWaitMs = m_waitMs.average();
+
+    std::vector<float> sorted = m_frameMs.values;
+    if (!sorted.empty()) {
+        std::sort(sorted.begin(), sorted.end());
+        const auto at = [&](double fraction) {
+            return static_cast<double>(sorted[static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5)]);
+        };
+        stats.p50FrameMs = at(0.50);
+        stats.p99FrameMs = at(0.99);
+        stats.maxFrameMs = static_cast<double>(sorted.back());
+    }
+    return stats;
+}
+
+void FramePacer::printReport() const {
+    const FrameTimingStats stats = getStats();
+    std::cout << std::fixed << std::setprecision(2)
+              << "Frame pacing: " << stats.frameCount << " frames, frame " << stats.averageFrameMs
+              << " ms avg (p50 " << stats.p50FrameMs << ", p99 " << stats.p99FrameMs << ", max " << stats.maxFrameMs
+              << "), CPU " << stats.averageCpuMs << " ms";
+    if (stats.gpuSampleCount > 0) {
+        std::cout << ", GPU " << stats.averageGpuMs << " ms";
+    }
+    std::cout << ", waiting " << stats.averageWaitMs << " ms\n" << std::defaultfloat;
+}
+
+VkPresentModeKHR FramePacer::choosePresentMode(const std::vector<VkPresentModeKHR>& available, bool vsync,
+                                               bool lowLatency) {
+    const auto has = [&](VkPresentModeKHR mode) {
+        return std::find(available.begin(), available.end(), mode) != available.end();
+    };
+
+    if (!vsync) {
+        if (has(VK_PRESENT_MODE_IMMEDIATE_KHR)) {
+            return VK_PRESENT_MODE_IMMEDIATE_KHR;
+        }
+        if (has(VK_PRESENT_MODE_MAILBOX_KHR)) {
+            return VK_PRESENT_MODE_MAILBOX_KHR;
+        }
+    } else if (lowLatency && has(VK_PRESENT_MODE_MAILBOX_KHR)) {
+        return VK_PRESENT_MODE_MAILBOX_KHR;
+    }
+    return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline) {
+    // Leave a margin for wake-up latency and spin through it
+    const auto spin = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::micro>(m_sleepOvershootUs * 1.5 + 50.0));
+    const auto sleepTarget = deadline - spin;
+
+    if (Clock::now() < sleepTarget) {
+        if (m_wait) {
+            // The wait returns early whenever an event is dispatched; keep waiting out the rest
+            for (auto now = Clock::now(); now < sleepTarget; now = Clock::now()) {
+                m_wait(std::chrono::duration<double>(sleepTarget - now).count());
+            }
+        } else {
+            std::this_thread::sleep_until(sleepTarget);
+        }
+        const double overshootUs = std::chrono::duration<double, std::micro>(Clock::now() - sleepTarget).count();
+        m_sleepOvershootUs += (overshootUs - m_sleepOvershootUs) * 0.1;
+    }
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::SampleRing::push(double value, size_t capacity) {
+    if (values.size() < capacity) {
+        values.push_back(static_cast<float>(value));
+        return;
+    }
+    values[cursor] = static_cast<float>(value);
+    cursor = (cursor + 1) % capacity;
+}
+
+double FramePacer::SampleRing::average() const {
+    double total = 0.0;
+    for (float value : values) {
+        total += static_cast<double>(value);
+    }
+    return values.empty() ? 0.0 : total / static_cast<double>(values.size());
+}
+
+} // namespace ct
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace ct {
+
+class VulkanContext;
+
+/// Configuration for frame pacing
+struct FramePacerConfig {
+    double targetFps = 60.0;            // Frame rate cap (0 = uncapped)
+    bool vsync = true;                  // Prefer tear-free present modes
+    bool lowLatency = true;             // Keep the CPU at most maxQueuedFrames ahead of the display
+    uint32_t maxQueuedFrames = 1;       // Presents allowed in flight before beginFrame() blocks
+    uint32_t historyFrames = 1024;      // Frame times kept for statistics
+};
+
+/// Frame time statistics over the recorded history, in milliseconds
+struct FrameTimingStats {
+    uint64_t frameCount = 0;
+    double averageFrameMs = 0.0;        // Start-to-start interval
+    double p50FrameMs = 0.0;
+    double p99FrameMs = 0.0;
+    double maxFrameMs = 0.0;
+    double averageCpuMs = 0.0;          // Time between beginFrame() and endFrame()
+    double averageGpuMs = 0.0;          // From recordGpuTime()
+    size_t gpuSampleCount = 0;          // 0 if nothing reports GPU time
+    double averageWaitMs = 0.0;         // Time spent blocked by the pacer
+};
+
+/// Holds the main loop to a target frame rate without burning a core
+///
+/// endFrame() sleeps until just before the next deadline and spins only for the remainder.
+/// The spin window tracks how late the OS has been waking us, so it stays small on a quiet
+/// system. With VK_KHR_present_wait, beginFrame() also blocks until earlier presents have
+/// reached the screen, so input is sampled as late as possible.
+class FramePacer {
+public:
+    /// Blocks for up to the given number of seconds; may return early
+    using WaitFunction = std::function<void(double seconds)>;
+
+    FramePacer() = default;
+    ~FramePacer();
+
+    // Non-copyable
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    /// Configure the pacer
+    /// @param config Pacing configuration settings
+    /// @param context Device used for present mode selection and present wait (optional)
+    /// @return true if initialization succeeded
+    bool initialize(const FramePacerConfig& config = {}, const VulkanContext* context = nullptr);
+
+    /// Release timer resources
+    void shutdown();
+
+    /// Mark the start of CPU work for a frame (blocks on present wait when enabled)
+    void beginFrame();
+
+    /// Mark the end of CPU work and wait for the next frame deadline
+    void endFrame();
+
+    /// Restart pacing after the loop was idle, so the gap is not recorded as a slow frame
+    void resume();
+
+    /// Report the GPU time of a completed frame (see GpuFrameTimer)
+    void recordGpuTime(double milliseconds);
+
+    /// Set the swapchain whose presents are waited on
+    void setSwapchain(VkSwapchainKHR swapchain);
+
+    /// Take the id to chain into VkPresentIdKHR for the next present
+    /// @return Present id, or 0 when present wait is unavailable
+    uint64_t nextPresentId();
+
+    /// Sleep through this instead of a plain thread sleep
+    /// Passing Window::waitEvents lets input be dispatched, and timestamped, while the loop waits
+    void setWaitFunction(WaitFunction wait) { m_wait = std::move(wait); }
+
+    /// Change the frame rate cap (0 = uncapped)
+    void setTargetFps(double fps);
+
+    /// Get the present mode chosen for the swapchain
+    [[nodiscard]] VkPresentModeKHR getPresentMode() const { return m_presentMode; }
+
+    /// Compute statistics over the recorded history
+    [[nodiscard]] FrameTimingStats getStats() const;
+
+    /// Print a one-line summary of getStats(); GPU time only appears once recordGpuTime() has been called
+    void printReport() const;
+
+    /// Choose a present mode for the pacing goals
+    /// vsync + lowLatency prefers MAILBOX (no tearing, no queue build-up); vsync alone uses FIFO;
+    /// no vsync prefers IMMEDIATE. FIFO is the fallback since it is always supported.
+    static VkPresentModeKHR choosePresentMode(const std::vector<VkPresentModeKHR>& available, bool vsync,
+                                              bool lowLatency);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /// Sleep until shortly before the deadline, then spin
+    void waitUntil(Clock::time_point deadline);
+
+    /// Fixed-capacity ring of recent samples
+    struct SampleRing {
+        std::vector<float> values;
+        size_t cursor = 0;
+
+        void push(double value, size_t capacity);
+        [[nodiscard]] double average() const;
+    };
+
+    FramePacerConfig m_config;
+    Clock::duration m_period{};
+    Clock::time_point m_frameStart{};
+    Clock::time_point m_lastFrameStart{};
+    Clock::time_point m_deadline{};
+    bool m_hasDeadline = false;
+    bool m_resumed = false;             // Skip the interval ending at the next beginFrame()
+    bool m_initialized = false;
+
+    WaitFunction m_wait;
+
+    // How late sleeps wake up (exponential moving average), used to size the spin window
+    double m_sleepOvershootUs = 1000.0;
+
+    // Present wait
+    VkPresentModeKHR m_presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkSwapchainKHR m_swapchain = VK_NULL_HANDLE;
+    PFN_vkWaitForPresentKHR m_waitForPresent = nullptr;
+    uint64_t m_presentId = 0;
+
+    // History
+    SampleRing m_frameMs;
+    SampleRing m_cpuMs;
+    SampleRing m_gpuMs;
+    SampleRing m_waitMs;
+    double m_frameWaitMs = 0.0;         // Blocked time accumulated during the current frame
+    uint64_t m_frameCount = 0;
+};
+
+} // namespace ct
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace ct {
+
+/// 64-bit non-cryptographic content hash (XXH64)
+/// Stable across platforms and runs, so hashes may be persisted to disk
+class Hasher64 {
+public:
+    explicit Hasher64(uint64_t seed = 0) { reset(seed); }
+
+    /// Restart hashing with a new seed
+    void reset(uint64_t seed = 0) {
+        m_acc[0] = seed + kPrime1 + kPrime2;
+        m_acc[1] = seed + kPrime2;
+        m_acc[2] = seed;
+        m_acc[3] = seed - kPrime1;
+        m_seed = seed;
+        m_totalLength = 0;
+        m_bufferSize = 0;
+    }
+
+    /// Feed bytes into the hash
+    void update(const void* data, size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        m_totalLength += size;
+
+        if (m_bufferSize + size < sizeof(m_buffer)) {
+            std::memcpy(m_buffer + m_bufferSize, bytes, size);
+            m_bufferSize += size;
+            return;
+        }
+
+        if (m_bufferSize > 0) {
+            const size_t fill = sizeof(m_buffer) - m_bufferSize;
+            std::memcpy(m_buffer + m_bufferSize, bytes, fill);
+            consumeStripe(m_buffer);
+            bytes += fill;
+            size -= fill;
+            m_bufferSize = 0;
+        }
+
+        while (size >= sizeof(m_buffer)) {
+            consumeStripe(bytes);
+            bytes += sizeof(m_buffer);
+            size -= sizeof(m_buffer);
+        }
+
+        std::memcpy(m_buffer, bytes, size);
+        m_bufferSize = size;
+    }
+
+    /// Feed a trivially copyable value into the hash
+    template <typename T>
+    void updateValue(const T& value) { update(&value, sizeof(T)); }
+
+    /// Feed a string (length-prefixed so concatenations don't collide)
+    void updateString(std::string_view text) {
+        const uint64_t length = text.size();
+        updateValue(length);
+        update(text.data(), text.size());
+    }
+
+    /// Produce the final hash value (does not modify state)
+    [[nodiscard]] uint64_t digest() const {
+        uint64_t h;
+        if (m_totalLength >= sizeof(m_buffer)) {
+            h = rotl(m_acc[0], 1) + rotl(m_acc[1], 7) + rotl(m_acc[2], 12) + rotl(m_acc[3], 18);
+            for (uint64_t acc : m_acc) {
+                h = (h ^ round(0, acc)) * kPrime1 + kPrime4;
+            }
+        } else {
+            h = m_seed + kPrime5;
+        }
+
+        h += m_totalLength;
+
+        const uint8_t* p = m_buffer;
+        size_t remaining = m_bufferSize;
+        while (remaining >= 8) {
+            h ^= round(0, read64(p));
+            h = rotl(h, 27) * kPrime1 + kPrime4;
+            p += 8;
+            remaining -= 8;
+        }
+        if (remaining >= 4) {
+            h ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+            h = rotl(h, 23) * kPrime2 + kPrime3;
+            p += 4;
+            remaining -= 4;
+        }
+        while (remaining > 0) {
+            h ^= *p * kPrime5;
+            h = rotl(h, 11) * kPrime1;
+            p++;
+            remaining--;
+        }
+
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+private:
+    static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+    static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+    static constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+    static constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    static uint64_t round(uint64_t acc, uint64_t input) {
+        acc += input * kPrime2;
+        return rotl(acc, 31) * kPrime1;
+    }
+
+    static uint64_t read64(const uint8_t* p) {
+        uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static uint32_t read32(const uint8_t* p) {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    void consumeStripe(const uint8_t* p) {
+        for (size_t i = 0; i < 4; i++) {
+            m_acc[i] = round(m_acc[i], read64(p + i * 8));
+        }
+    }
+
+    uint64_t m_acc[4];
+    uint64_t m_seed;
+    uint64_t m_totalLength;
+    uint8_t m_buffer[32];
+    size_t m_bufferSize;
+};
+
+/// Hash a block of memory in one call
+[[nodiscard]] inline uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0) {
+    Hasher64 hasher(seed);
+    hasher.update(data, size);
+    return hasher.digest();
+}
+
+/// Mix a value into an existing hash (order dependent)
+[[nodiscard]] inline uint64_t hashCombine(uint64_t seed, uint64_t value) {
+    Hasher64 hasher(seed);
+    hasher.updateValue(value);
+    return hasher.digest();
+}
+
+} // namespace ct
@@ -0,0 +1,251 @@
+#include "core/input.h"
+#include "core/window.h"
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace ct {
+
+Input::~Input() {
+    shutdown();
+}
+
+bool Input::initialize(Window& window, const InputConfig& config) {
+    shutdown();
+
+    if (!window.getHandle()) {
+        std::cerr << "Failed to initialize input: window not created\n";
+        return false;
+    }
+
+    m_config = config;
+    m_events.initialize(config.queueCapacity);
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_window = &window;
+    m_window->setInput(this);
+
+    std::cout << "Input initialized (" << m_events.capacity() << " event queue, raw mouse motion "
+              << (config.rawMouseMotion && glfwRawMouseMotionSupported() ? "available" : "unavailable") << ")\n";
+    return true;
+}
+
+void Input::shutdown() {
+    if (!m_window) {
+        return;
+    }
+
+    setCursorCaptured(false);
+    m_window->setInput(nullptr);
+    m_window = nullptr;
+}
+
+void Input::setCursorCaptured(bool captured) {
+    if (!m_window || !m_window->getHandle()) {
+        return;
+    }
+
+    GLFWwindow* handle = m_window->getHandle();
+    glfwSetInputMode(handle, GLFW_CURSOR, captured ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
+
+    // Raw motion only applies while the cursor is disabled
+    const bool raw = captured && m_config.rawMouseMotion && glfwRawMouseMotionSupported();
+    if (glfwRawMouseMotionSupported()) {
+        glfwSetInputMode(handle, GLFW_RAW_MOUSE_MOTION, raw ? GLFW_TRUE : GLFW_FALSE);
+    }
+    m_rawMotionEnabled = raw;
+}
+
+double Input::now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Input::onKey(int key, int /*scancode*/, int action, int mods) {
+    InputEvent event;
+    event.time = now();
+    event.type = InputEventType::Key;
+    event.code = key;
+    event.action = static_cast<ButtonAction>(action);
+    event.mods = static_cast<uint16_t>(mods);
+    push(event);
+}
+
+void Input::onMouseButton(int button, int action, int mods) {
+    InputEvent event;
+    event.time = now();
+    event.type = InputEventType::MouseButton;
+    event.code = button;
+    event.action = static_cast<ButtonAction>(action);
+    event.mods = static_cast<uint16_t>(mods);
+    push(event);
+}
+
+void Input::onCursorPos(double x, double y) {
+    InputEvent event;
+    event.time = now();
+    event.type = InputEventType::MouseMove;
+    event.x = x;
+    event.y = y;
+    push(event);
+}
+
+void Input::onScroll(double xOffset, double yOffset) {
+    InputEvent event;
+    event.time = now();
+    event.type = InputEventType::Scroll;
+    event.x = xOffset;
+    event.y = yOffset;
+    push(event);
+}
+
+void Input::push(const InputEvent& event) {
+    if (!m_events.push(event)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+ActionId ActionMap::addAction(const std::string& name) {
+    const ActionId existing = findAction(name);
+    if (existing != kInvalidAction) {
+        return existing;
+    }
+
+    m_actions.push_back({name, 0});
+    return static_cast<ActionId>(m_actions.size() - 1);
+}
+
+ActionId ActionMap::findAction(const std::string& name) const {
+    for (size_t i = 0; i < m_actions.size(); i++) {
+        if (m_actions[i].name == name) {
+            return static_cast<ActionId>(i);
+        }
+    }
+    return kInvalidAction;
+}
+
+void ActionMap::bind(ActionId action, const ActionBinding& binding) {
+    if (action >= m_actions.size()) {
+        std::cerr << "Failed to bind input: unknown action " << action << "\n";
+        return;
+    }
+    m_bindings.push_back({action, binding, false});
+}
+
+void ActionMap::bindKey(ActionId action, int key, uint16_t mods) {
+    bind(action, {BindingSource::Key, key, mods, -1, 1.0f});
+}
+
+void ActionMap::bindMouseButton(ActionId action, int button, uint16_t mods) {
+    bind(action, {BindingSource::MouseButton, button, mods, -1, 1.0f});
+}
+
+void ActionMap::bindMouseMotion(ActionId action, int heldButton, float scale) {
+    bind(action, {BindingSource::MouseMotion, 0, 0, heldButton, scale});
+}
+
+void ActionMap::bindScroll(ActionId action, float scale) {
+    bind(action, {BindingSource::Scroll, 0, 0, -1, scale});
+}
+
+void ActionMap::unbind(ActionId action) {
+    std::erase_if(m_bindings, [action](const Binding& binding) { return binding.action == action; });
+    if (action < m_actions.size()) {
+        m_actions[action].heldBindings = 0;
+    }
+}
+
+void ActionMap::translate(const InputEvent& event, std::vector<ActionEvent>& actions) {
+    switch (event.type) {
+        case InputEventType::Key:
+            translateButton(event, BindingSource::Key, actions);
+            break;
+
+        case InputEventType::MouseButton:
+            if (event.code >= 0 && event.code < kMouseButtonCount) {
+                const uint32_t bit = 1u << event.code;
+                m_mouseButtonsDown = event.action == ButtonAction::Release ? m_mouseButtonsDown & ~bit
+                                                                           : m_mouseButtonsDown | bit;
+            }
+            translateButton(event, BindingSource::MouseButton, actions);
+            break;
+
+        case InputEventType::MouseMove: {
+            const bool hadCursor = m_hasCursor;
+            const glm::vec2 delta(static_cast<float>(event.x - m_cursorX), static_cast<float>(event.y - m_cursorY));
+            m_cursorX = event.x;
+            m_cursorY = event.y;
+            m_hasCursor = true;
+
+            // The first position has nothing to be relative to
+            if (!hadCursor) {
+                break;
+            }
+
+            for (const Binding& entry : m_bindings) {
+                const ActionBinding& binding = entry.binding;
+                if (binding.source != BindingSource::MouseMotion) {
+                    continue;
+                }
+                if (binding.heldButton >= 0 &&
+                    (binding.heldButton >= kMouseButtonCount || !(m_mouseButtonsDown & (1u << binding.heldButton)))) {
+                    continue;
+                }
+                actions.push_back({entry.action, ActionPhase::Moved, event.time, delta * binding.scale});
+            }
+            break;
+        }
+
+        case InputEventType::Scroll: {
+            const glm::vec2 offset(static_cast<float>(event.x), static_cast<float>(event.y));
+            for (const Binding& entry : m_bindings) {
+                if (entry.binding.source == BindingSource::Scroll) {
+                    actions.push_back({entry.action, ActionPhase::Moved, event.time, offset * entry.binding.scale});
+                }
+            }
+            break;
+        }
+    }
+}
+
+void ActionMap::translateButton(const InputEvent& event, BindingSource source, std::vector<ActionEvent>& actions) {
+    for (Binding& entry : m_bindings) {
+        const ActionBinding& binding = entry.binding;
+        if (binding.source != source || binding.code != event.code) {
+            continue;
+        }
+
+        Action& action = m_actions[entry.action];
+
+        if (event.action == ButtonAction::Press) {
+            // Modifiers are checked on press only, so releasing Ctrl before the key still ends the action
+            if (entry.held || (event.mods & binding.mods) != binding.mods) {
+                continue;
+            }
+            entry.held = true;
+            if (action.heldBindings++ == 0) {
+                actions.push_back({entry.action, ActionPhase::Pressed, event.time, glm::vec2(1.0f)});
+            }
+        } else if (event.action == ButtonAction::Release && entry.held) {
+            entry.held = false;
+            if (--action.heldBindings == 0) {
+                actions.push_back({entry.action, ActionPhase::Released, event.time, glm::vec2(0.0f)});
+            }
+        }
+    }
+}
+
+void ActionMap::resetState() {
+    for (Binding& entry : m_bindings) {
+        entry.held = false;
+    }
+    for (Action& action : m_actions) {
+        action.heldBindings = 0;
+    }
+    m_mouseButtonsDown = 0;
+    m_hasCursor = false;
+}
+
+} // namespace ct
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "core/spsc_ring.h"
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace ct {
+
+class Window;
+
+/// Kind of raw input event
+enum class InputEventType : uint8_t {
+    Key,
+    MouseButton,
+    MouseMove,
+    Scroll,
+};
+
+/// Button transition (values match GLFW_RELEASE, GLFW_PRESS and GLFW_REPEAT)
+enum class ButtonAction : uint8_t {
+    Release = 0,
+    Press = 1,
+    Repeat = 2,
+};
+
+/// One timestamped input event as delivered by GLFW
+struct InputEvent {
+    double time = 0.0;              // Seconds on Input::now()'s clock, taken when GLFW dispatched the event
+    double x = 0.0;                 // Cursor position (MouseMove) or scroll offset (Scroll)
+    double y = 0.0;
+    int32_t code = 0;               // GLFW key or mouse button
+    InputEventType type = InputEventType::Key;
+    ButtonAction action = ButtonAction::Press;
+    uint16_t mods = 0;              // GLFW modifier bits
+};
+
+/// Configuration for the input subsystem
+struct InputConfig {
+    uint32_t queueCapacity = 4096;  // Events buffered between producer and consumer
+    bool rawMouseMotion = true;     // Use unaccelerated motion while the cursor is captured
+};
+
+/// Collects GLFW input into a lock-free queue
+///
+/// Window callbacks run on the main thread and push events stamped with the time they were
+/// dispatched; exactly one other thread (simulation or a job) drains them with pollEvent().
+/// Nothing on that path allocates or locks. Because the main loop waits for frame deadlines
+/// inside Window::waitEvents(), events are dispatched as they arrive rather than once per frame,
+/// so a fast pan keeps its sub-frame motion.
+class Input {
+public:
+    Input() = default;
+    ~Input();
+
+    // Non-copyable
+    Input(const Input&) = delete;
+    Input& operator=(const Input&) = delete;
+
+    /// Allocate the event queue and attach to a window's callbacks
+    /// @param window Window delivering events (must outlive the input system)
+    /// @param config Input configuration settings
+    /// @return true if initialization succeeded
+    bool initialize(Window& window, const InputConfig& config = {});
+
+    /// Detach from the window
+    void shutdown();
+
+    /// Hide and lock the cursor for dragging, with raw motion when supported (main thread)
+    void setCursorCaptured(bool captured);
+
+    /// Check whether captured motion bypasses OS acceleration
+    [[nodiscard]] bool isRawMouseMotionEnabled() const { return m_rawMotionEnabled; }
+
+    /// Take the oldest queued event (consumer thread)
+    /// @return false if the queue is empty
+    bool pollEvent(InputEvent& event) { return m_events.pop(event); }
+
+    /// Get the number of events waiting
+    [[nodiscard]] size_t getQueuedCount() const { return m_events.size(); }
+
+    /// Get the number of events lost because the consumer fell behind
+    [[nodiscard]] uint64_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    /// Current time on the clock used for event timestamps, in seconds
+    static double now();
+
+    // Producer side, called from Window's GLFW callbacks
+    void onKey(int key, int scancode, int action, int mods);
+    void onMouseButton(int button, int action, int mods);
+    void onCursorPos(double x, double y);
+    void onScroll(double xOffset, double yOffset);
+
+private:
+    void push(const InputEvent& event);
+
+    SpscRing<InputEvent> m_events;
+    std::atomic<uint64_t> m_dropped{0};
+    Window* m_window = nullptr;
+    InputConfig m_config;
+    bool m_rawMotionEnabled = false;
+};
+
+/// Identifier returned by ActionMap::addAction
+using ActionId = uint32_t;
+constexpr ActionId kInvalidAction = std::numeric_limits<ActionId>::max();
+
+/// Where a binding takes its input from
+enum class BindingSource : uint8_t {
+    Key,
+    MouseButton,
+    MouseMotion,                    // Cursor delta
+    Scroll,                         // Wheel offset
+};
+
+/// Maps one physical input to an action
+struct ActionBinding {
+    BindingSource source = BindingSource::Key;
+    int32_t code = 0;               // GLFW key or mouse button (Key and MouseButton)
+    uint16_t mods = 0;              // Modifiers that must be held
+    int32_t heldButton = -1;        // Mouse button that must be down (MouseMotion, -1 = any state)
+    float scale = 1.0f;             // Multiplier applied to motion and scroll values
+};
+
+/// State change of an action
+enum class ActionPhase : uint8_t {
+    Pressed,
+    Released,
+    Moved,
+};
+
+/// An action triggered by a raw event, carrying that event's timestamp
+struct ActionEvent {
+    ActionId action = kInvalidAction;
+    ActionPhase phase = ActionPhase::Pressed;
+    double time = 0.0;
+    glm::vec2 value{0.0f};          // Scaled delta for Moved
+};
+
+/// Translates raw input events into named actions ("pan", "zoom", "select")
+///
+/// Buttons report Pressed and Released once per action even when several bindings are held;
+/// motion and scroll bindings report per-event deltas so consumers can integrate them at
+/// the exact event times. Owned by the consuming thread.
+class ActionMap {
+public:
+    /// Register an action
+    /// @return Id of the action (the existing id if the name is already registered)
+    ActionId addAction(const std::string& name);
+
+    /// Look up an action by name
+    /// @return Id, or kInvalidAction if unknown
+    [[nodiscard]] ActionId findAction(const std::string& name) const;
+
+    [[nodiscard]] const std::string& getActionName(ActionId action) const { return m_actions[action].name; }
+
+    /// Attach a binding to an action
+    void bind(ActionId action, const ActionBinding& binding);
+
+    void bindKey(ActionId action, int key, uint16_t mods = 0);
+    void bindMouseButton(ActionId action, int button, uint16_t mods = 0);
+    void bindMouseMotion(ActionId action, int heldButton = -1, float scale = 1.0f);
+    void bindScroll(ActionId action, float scale = 1.0f);
+
+    /// Remove every binding of an action
+    void unbind(ActionId action);
+
+    /// Translate one raw event, appending the resulting action events
+    void translate(const InputEvent& event, std::vector<ActionEvent>& actions);
+
+    /// Check whether any binding of a button action is held
+    [[nodiscard]] bool isPressed(ActionId action) const { return m_actions[action].heldBindings > 0; }
+
+    /// Forget held buttons and the last cursor position (e.g. after focus loss)
+    void resetState();
+
+private:
+    struct Action {
+        std::string name;
+        uint32_t heldBindings = 0;
+    };
+
+    struct Binding {
+        ActionId action = kInvalidAction;
+        ActionBinding binding;
+        bool held = false;
+    };
+
+    static constexpr int kMouseButtonCount = 8;
+
+    void translateButton(const InputEvent& event, BindingSource source, std::vector<ActionEvent>& actions);
+
+    std::vector<Action> m_actions;
+    std::vector<Binding> m_bindings;
+    uint32_t m_mouseButtonsDown = 0;
+    double m_cursorX = 0.0;
+    double m_cursorY = 0.0;
+    bool m_hasCursor = false;
+};
+
+} // namespace ct
@@ -0,0 +1,151 @@
+#include "core/job_system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+
+namespace ct {
+
+JobSystem::~JobSystem() {
+    shutdown();
+}
+
+bool JobSystem::initialize(uint32_t threadCount) {
+    if (!m_workers.empty()) {
+        return true;
+    }
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_stopping = false;
+    m_workers.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++) {
+        m_workers.emplace_back(&JobSystem::workerLoop, this);
+    }
+
+    std::cout << "Job system started with " << threadCount << " worker(s).\n";
+    return true;
+}
+
+void JobSystem::shutdown() {
+    if (m_workers.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_jobAvailable.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+void JobSystem::submit(Job job) {
+    // Without workers (not initialized) run inline so callers still make progress
+    if (m_workers.empty()) {
+        job();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(job));
+    }
+    m_jobAvailable.notify_one();
+}
+
+void JobSystem::waitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_queue.empty() && m_activeJobs == 0; });
+}
+
+void JobSystem::parallelFor(size_t count, size_t batchSize, const RangeJob& body) {
+    if (count == 0) {
+        return;
+    }
+
+    const size_t threads = m_workers.size() + 1;
+    if (batchSize == 0) {
+        batchSize = std::max<size_t>(1, (count + threads - 1) / threads);
+    }
+
+    const size_t batchCount = (count + batchSize - 1) / batchSize;
+    if (batchCount == 1 || m_workers.empty()) {
+        body(0, count);
+        return;
+    }
+
+    // Shared so helpers that start after the caller returned see no work left
+    struct State {
+        std::atomic<size_t> nextBatch{0};
+        std::atomic<size_t> completedBatches{0};
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto state = std::make_shared<State>();
+
+    auto runBatches = [state, count, batchSize, batchCount, &body] {
+        for (;;) {
+            const size_t batch = state->nextBatch.fetch_add(1);
+            if (batch >= batchCount) {
+                return;
+            }
+
+            const size_t begin = batch * batchSize;
+            body(begin, std::min(count, begin + batchSize));
+
+            if (state->completedBatches.fetch_add(1) + 1 == batchCount) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->done.notify_all();
+            }
+        }
+    };
+
+    const size_t helpers = std::min(m_workers.size(), batchCount - 1);
+    for (size_t i = 0; i < helpers; i++) {
+        submit(runBatches);
+    }
+
+    runBatches();
+
+    // Only wait for batches already claimed by other threads, never for queued helpers
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&] { return state->completedBatches.load() == batchCount; });
+}
+
+void JobSystem::workerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobAvailable.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+
+            if (m_queue.empty()) {
+                return;  // Stopping and fully drained
+            }
+
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_activeJobs++;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_activeJobs--;
+            if (m_queue.empty() && m_activeJobs == 0) {
+                m_idle.notify_all();
+            }
+        }
+    }
+}
+
+} // namespace ct
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ct {
+
+/// Fixed-size worker thread pool for CPU-bound engine and tool work
+/// Jobs are fire-and-forget; use waitIdle() or parallelFor() to join
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    /// Body of a parallelFor batch, called with the half-open range [begin, end)
+    using RangeJob = std::function<void(size_t begin, size_t end)>;
+
+    JobSystem() = default;
+    ~JobSystem();
+
+    // Non-copyable
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /// Start the worker threads
+    /// @param threadCount Number of workers (0 = one per hardware thread)
+    /// @return true if the workers were started
+    bool initialize(uint32_t threadCount = 0);
+
+    /// Drain the queue and join all workers
+    void shutdown();
+
+    /// Queue a job for execution on a worker thread
+    void submit(Job job);
+
+    /// Block until every submitted job has finished
+    void waitIdle();
+
+    /// Run body over [0, count) in batches across all workers and the calling thread
+    /// Safe to call from inside a job: the caller works through unclaimed batches itself
+    /// @param count Number of items
+    /// @param batchSize Items per batch (0 = split evenly across threads)
+    /// @param body Callback invoked once per batch
+    void parallelFor(size_t count, size_t batchSize, const RangeJob& body);
+
+    /// Get the number of worker threads
+    [[nodiscard]] uint32_t getThreadCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+private:
+    /// Worker thread entry point
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<Job> m_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::condition_variable m_idle;
+    size_t m_activeJobs = 0;
+    bool m_stopping = false;
+};
+
+} // namespace ct
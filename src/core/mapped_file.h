@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace ct {
+
+/// Read-only memory mapping of a whole file
+/// Pages are loaded on first touch and shared with the OS page cache
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // Non-copyable
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Map a file
+    /// @param path File to map
+    /// @return true if the file was mapped
+    bool open(const std::filesystem::path& path);
+
+    /// Unmap the file
+    void close();
+
+    [[nodiscard]] bool isOpen() const { return m_data != nullptr; }
+    [[nodiscard]] const uint8_t* getData() const { return m_data; }
+    [[nodiscard]] size_t getSize() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+};
+
+} // namespace ct
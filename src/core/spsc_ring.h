@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+namespace ct {
+
+/// Bounded single-producer, single-consumer queue
+///
+/// push() and pop() are wait-free and never allocate; storage is sized once by initialize().
+/// One thread may push and one (other) thread may pop concurrently. Each side keeps a cached
+/// copy of the other side's index so the shared cache lines are only read when the ring looks
+/// full or empty.
+template <typename T>
+class SpscRing {
+public:
+    SpscRing() = default;
+
+    // Non-copyable
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /// Allocate storage (not thread-safe; call before either side starts)
+    /// @param capacity Minimum number of elements, rounded up to a power of two
+    void initialize(size_t capacity) {
+        const size_t size = std::bit_ceil(std::max<size_t>(capacity, 2));
+        m_slots.assign(size, T{});
+        m_mask = size - 1;
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+        m_cachedHead = 0;
+        m_cachedTail = 0;
+    }
+
+    /// Append an element (producer thread)
+    /// @return false if the ring is full
+    bool push(const T& value) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) {
+                return false;
+            }
+        }
+
+        m_slots[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Remove the oldest element (consumer thread)
+    /// @return false if the ring is empty
+    bool pop(T& value) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;
+            }
+        }
+
+        value = m_slots[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Get the number of queued elements (approximate while the other side is active)
+    [[nodiscard]] size_t size() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t capacity() const { return m_slots.size(); }
+
+private:
+    static constexpr size_t kCacheLineSize = 64;
+
+    std::vector<T> m_slots;
+    size_t m_mask = 0;
+
+    // Consumer side
+    alignas(kCacheLineSize) std::atomic<size_t> m_head{0};
+    size_t m_cachedTail = 0;
+
+    // Producer side
+    alignas(kCacheLineSize) std::atomic<size_t> m_tail{0};
+    size_t m_cachedHead = 0;
+};
+
+} // namespace ct
@@ -0,0 +1,182 @@
+#include "core/startup_graph.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace ct {
+
+namespace {
+
+constexpr uint32_t kNoStage = UINT32_MAX;
+
+} // namespace
+
+StartupGraph::StageId StartupGraph::addStage(const std::string& name, StageThread thread,
+                                             const std::vector<StageId>& dependencies, StageFunction function) {
+    const StageId id = static_cast<StageId>(m_stages.size());
+
+    Stage stage;
+    stage.name = name;
+    stage.thread = thread;
+    stage.function = std::move(function);
+    for (StageId dependency : dependencies) {
+        if (dependency >= id) {
+            std::cerr << "Startup stage '" << name << "' depends on a stage added after it\n";
+            continue;
+        }
+        stage.dependencies.push_back(dependency);
+        m_stages[dependency].dependents.push_back(id);
+    }
+
+    m_stages.push_back(std::move(stage));
+    return id;
+}
+
+bool StartupGraph::run() {
+    m_start = Clock::now();
+    for (Stage& stage : m_stages) {
+        stage.pendingDependencies = static_cast<uint32_t>(stage.dependencies.size());
+        stage.started = false;
+        stage.finished = false;
+        stage.succeeded = false;
+    }
+
+    std::mutex mutex;
+    std::condition_variable stageFinished;
+    std::vector<std::thread> threads;
+    size_t running = 0;
+    size_t succeeded = 0;
+    bool failed = false;
+
+    // Called with the mutex held
+    const auto finish = [&](StageId id, bool ok) {
+        Stage& stage = m_stages[id];
+        stage.endMs = now();
+        stage.finished = true;
+        stage.succeeded = ok;
+        running--;
+
+        if (!ok) {
+            std::cerr << "Startup stage failed: " << stage.name << "\n";
+            failed = true;
+            return;
+        }
+        succeeded++;
+        for (StageId dependent : stage.dependents) {
+            m_stages[dependent].pendingDependencies--;
+        }
+    };
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        // Launch every ready worker stage; run one ready main-thread stage at a time
+        StageId mainStage = kNoStage;
+        for (StageId id = 0; !failed && id < m_stages.size(); id++) {
+            Stage& stage = m_stages[id];
+            if (stage.started || stage.pendingDependencies > 0) {
+                continue;
+            }
+
+            if (stage.thread == StageThread::Worker) {
+                stage.started = true;
+                stage.startMs = now();
+                running++;
+                threads.emplace_back([&, id] {
+                    const bool ok = m_stages[id].function();
+                    std::lock_guard<std::mutex> guard(mutex);
+                    finish(id, ok);
+                    stageFinished.notify_one();
+                });
+            } else if (mainStage == kNoStage) {
+                mainStage = id;
+            }
+        }
+
+        if (mainStage != kNoStage) {
+            Stage& stage = m_stages[mainStage];
+            stage.started = true;
+            stage.startMs = now();
+            running++;
+
+            lock.unlock();
+            const bool ok = stage.function();
+            lock.lock();
+            finish(mainStage, ok);
+            continue;
+        }
+
+        if (running == 0) {
+            break;
+        }
+        stageFinished.wait(lock);
+    }
+    lock.unlock();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    m_elapsedMs = now();
+    return !failed && succeeded == m_stages.size();
+}
+
+void StartupGraph::printReport() const {
+    size_t nameWidth = 5;
+    for (const Stage& stage : m_stages) {
+        nameWidth = std::max(nameWidth, stage.name.size());
+    }
+
+    std::cout << std::fixed << std::setprecision(2) << "Startup: " << m_elapsedMs << " ms\n"
+              << "  " << std::left << std::setw(static_cast<int>(nameWidth)) << "stage" << "  thread  "
+              << std::right << std::setw(9) << "start ms" << std::setw(10) << "time ms" << "\n";
+
+    for (const Stage& stage : m_stages) {
+        std::cout << "  " << std::left << std::setw(static_cast<int>(nameWidth)) << stage.name << "  "
+                  << std::setw(6) << (stage.thread == StageThread::Main ? "main" : "worker") << std::right;
+        if (!stage.finished) {
+            std::cout << "  " << std::setw(9) << "-" << std::setw(10) << "skipped" << "\n";
+        } else {
+            std::cout << "  " << std::setw(9) << stage.startMs << std::setw(10) << stage.endMs - stage.startMs
+                      << (stage.succeeded ? "" : "  FAILED") << "\n";
+        }
+    }
+
+    // Walk back from the last stage to finish through whichever dependency finished last
+    StageId current = kNoStage;
+    for (StageId id = 0; id < m_stages.size(); id++) {
+        if (m_stages[id].finished && (current == kNoStage || m_stages[id].endMs > m_stages[current].endMs)) {
+            current = id;
+        }
+    }
+
+    std::vector<StageId> path;
+    while (current != kNoStage) {
+        path.push_back(current);
+        StageId latest = kNoStage;
+        for (StageId dependency : m_stages[current].dependencies) {
+            if (latest == kNoStage || m_stages[dependency].endMs > m_stages[latest].endMs) {
+                latest = dependency;
+            }
+        }
+        current = latest;
+    }
+
+    if (!path.empty()) {
+        std::cout << "  Critical path:";
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            std::cout << (it == path.rbegin() ? " " : " -> ") << m_stages[*it].name;
+        }
+        std::cout << "\n";
+    }
+    std::cout << std::defaultfloat;
+}
+
+double StartupGraph::now() const {
+    return std::chrono::duration<double, std::milli>(Clock::now() - m_start).count();
+}
+
+} // namespace ct
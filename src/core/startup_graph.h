@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ct {
+
+/// Thread a startup stage runs on
+enum class StageThread : uint8_t {
+    Main,       // The thread that called run() (window system calls)
+    Worker,     // A short-lived thread of its own
+};
+
+/// Startup work as a dependency graph
+///
+/// Each stage starts as soon as every stage it depends on has finished, so independent work
+/// (instance creation, file reads, window creation) overlaps. Worker stages get a thread each;
+/// startup has only a handful of them and must not wait for a pool to spin up.
+class StartupGraph {
+public:
+    using StageId = uint32_t;
+
+    /// Stage body; returning false aborts startup
+    using StageFunction = std::function<bool()>;
+
+    StartupGraph() = default;
+
+    // Non-copyable
+    StartupGraph(const StartupGraph&) = delete;
+    StartupGraph& operator=(const StartupGraph&) = delete;
+
+    /// Add a stage
+    /// @param name Name shown in the timing report
+    /// @param thread Thread the stage must run on
+    /// @param dependencies Stages that must finish first (added earlier)
+    /// @param function Stage body
+    /// @return Id to depend on from later stages
+    StageId addStage(const std::string& name, StageThread thread, const std::vector<StageId>& dependencies,
+                     StageFunction function);
+
+    /// Run every stage and wait for all of them
+    /// After a failure no further stages are started; stages already running are waited for.
+    /// @return true if every stage succeeded
+    bool run();
+
+    /// Print start time and duration of each stage, and the critical path
+    void printReport() const;
+
+    /// Get the wall time of the last run() in milliseconds
+    [[nodiscard]] double getElapsedMs() const { return m_elapsedMs; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stage {
+        std::string name;
+        StageThread thread = StageThread::Main;
+        std::vector<StageId> dependencies;
+        std::vector<StageId> dependents;
+        StageFunction function;
+        uint32_t pendingDependencies = 0;
+        bool started = false;
+        bool finished = false;
+        bool succeeded = false;
+        double startMs = 0.0;
+        double endMs = 0.0;
+    };
+
+    /// Milliseconds since run() began
+    [[nodiscard]] double now() const;
+
+    std::vector<Stage> m_stages;
+    Clock::time_point m_start{};
+    double m_elapsedMs = 0.0;
+};
+
+} // namespace ct
@@ -1,4 +1,5 @@
 #include "core/window.h"
+#include "core/input.h"
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
@@ -17,11 +18,15 @@ Window::Window(Window&& other) noexcept
     , m_width(other.m_width)
     , m_height(other.m_height)
     , m_framebufferResized(other.m_framebufferResized)
+    , m_activity(other.m_activity)
+    , m_input(other.m_input)
 {
     other.m_window = nullptr;
     other.m_width = 0;
     other.m_height = 0;
     other.m_framebufferResized = false;
+    other.m_activity = false;
+    other.m_input = nullptr;
 
     // Update user pointer to new location
     if (m_window) {
@@ -37,11 +42,15 @@ Window& Window::operator=(Window&& other) noexcept {
         m_width = other.m_width;
         m_height = other.m_height;
         m_framebufferResized = other.m_framebufferResized;
+        m_activity = other.m_activity;
+        m_input = other.m_input;
 
         other.m_window = nullptr;
         other.m_width = 0;
         other.m_height = 0;
         other.m_framebufferResized = false;
+        other.m_activity = false;
+        other.m_input = nullptr;
 
         if (m_window) {
             glfwSetWindowUserPointer(m_window, this);
@@ -50,8 +59,8 @@ Window& Window::operator=(Window&& other) noexcept {
     return *this;
 }
 
-bool Window::initialize(const WindowConfig& config) {
-    // Initialize GLFW
+bool Window::initializePlatform() {
+    // Initialize GLFW (no-op if already initialized)
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW\n";
         return false;
@@ -63,6 +72,17 @@ bool Window::initialize(const WindowConfig& config) {
         glfwTerminate();
         return false;
     }
+    return true;
+}
+
+void Window::shutdownPlatform() {
+    glfwTerminate();
+}
+
+bool Window::initialize(const WindowConfig& config) {
+    if (!initializePlatform()) {
+        return false;
+    }
 
     // Set window hints for Vulkan (no OpenGL context)
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
@@ -91,7 +111,6 @@ bool Window::initialize(const WindowConfig& config) {
 
     if (!m_window) {
         std::cerr << "Failed to create GLFW window\n";
-        glfwTerminate();
         return false;
     }
 
@@ -101,6 +120,14 @@ bool Window::initialize(const WindowConfig& config) {
     // Set up framebuffer resize callback
     glfwSetFramebufferSizeCallback(m_window, framebufferResizeCallback);
 
+    // Any input or expose event means the next frame must be drawn
+    glfwSetKeyCallback(m_window, keyCallback);
+    glfwSetMouseButtonCallback(m_window, mouseButtonCallback);
+    glfwSetCursorPosCallback(m_window, cursorPosCallback);
+    glfwSetScrollCallback(m_window, scrollCallback);
+    glfwSetWindowRefreshCallback(m_window, refreshCallback);
+    glfwSetWindowFocusCallback(m_window, focusCallback);
+
     // Get actual framebuffer size (may differ from window size on high-DPI)
     int fbWidth, fbHeight;
     glfwGetFramebufferSize(m_window, &fbWidth, &fbHeight);
@@ -122,6 +149,7 @@ void Window::shutdown() {
     m_width = 0;
     m_height = 0;
     m_framebufferResized = false;
+    m_activity = false;
 }
 
 bool Window::shouldClose() const {
@@ -132,6 +160,14 @@ void Window::pollEvents() {
     glfwPollEvents();
 }
 
+void Window::waitEvents(double timeoutSeconds) {
+    glfwWaitEventsTimeout(timeoutSeconds);
+}
+
+void Window::postEmptyEvent() {
+    glfwPostEmptyEvent();
+}
+
 const char** Window::getRequiredInstanceExtensions(uint32_t* count) {
     return glfwGetRequiredInstanceExtensions(count);
 }
@@ -145,4 +181,44 @@ void Window::framebufferResizeCallback(GLFWwindow* window, int width, int height
     }
 }
 
+void Window::keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (Window* app = markActivity(window); app && app->m_input) {
+        app->m_input->onKey(key, scancode, action, mods);
+    }
+}
+
+void Window::mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
+    if (Window* app = markActivity(window); app && app->m_input) {
+        app->m_input->onMouseButton(button, action, mods);
+    }
+}
+
+void Window::cursorPosCallback(GLFWwindow* window, double x, double y) {
+    if (Window* app = markActivity(window); app && app->m_input) {
+        app->m_input->onCursorPos(x, y);
+    }
+}
+
+void Window::scrollCallback(GLFWwindow* window, double xOffset, double yOffset) {
+    if (Window* app = markActivity(window); app && app->m_input) {
+        app->m_input->onScroll(xOffset, yOffset);
+    }
+}
+
+void Window::refreshCallback(GLFWwindow* window) {
+    markActivity(window);
+}
+
+void Window::focusCallback(GLFWwindow* window, int) {
+    markActivity(window);
+}
+
+Window* Window::markActivity(GLFWwindow* window) {
+    auto* app = static_cast<Window*>(glfwGetWindowUserPointer(window));
+    if (app) {
+        app->m_activity = true;
+    }
+    return app;
+}
+
 } // namespace ct
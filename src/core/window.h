@@ -8,6 +8,8 @@ struct GLFWwindow;
 
 namespace ct {
 
+class Input;
+
 /// Configuration settings for window creation
 struct WindowConfig {
     std::string title = "Cellular Threshold";
@@ -33,7 +35,18 @@ public:
     Window(Window&& other) noexcept;
     Window& operator=(Window&& other) noexcept;
 
+    /// Initialize GLFW and check for Vulkan support (main thread only)
+    /// Called by initialize(); calling it earlier lets Vulkan instance creation start before the
+    /// window exists.
+    /// @return true if the window system is ready
+    static bool initializePlatform();
+
+    /// Terminate GLFW when startup fails before a window was created
+    static void shutdownPlatform();
+
     /// Initialize the window with the given configuration
+    /// GLFW stays initialized on failure, since other startup work may still be using it;
+    /// call shutdownPlatform() once that work has finished.
     /// @param config Window configuration settings
     /// @return true if initialization succeeded
     bool initialize(const WindowConfig& config = {});
@@ -47,6 +60,13 @@ public:
     /// Poll for window/input events
     void pollEvents();
 
+    /// Block until an event arrives or the timeout expires, then process events
+    /// @param timeoutSeconds Longest time to sleep
+    void waitEvents(double timeoutSeconds);
+
+    /// Wake a thread blocked in waitEvents() (safe to call from any thread)
+    static void postEmptyEvent();
+
     /// Get the raw GLFW window handle (for Vulkan surface creation)
     [[nodiscard]] GLFWwindow* getHandle() const { return m_window; }
 
@@ -60,6 +80,15 @@ public:
     /// Reset the resize flag (call after handling resize)
     void resetResizeFlag() { m_framebufferResized = false; }
 
+    /// Check if input or a window refresh/focus event arrived since the last reset
+    [[nodiscard]] bool hasActivity() const { return m_activity; }
+
+    /// Reset the activity flag (call after the frame reacting to it was drawn)
+    void resetActivity() { m_activity = false; }
+
+    /// Forward input callbacks to an input system (nullptr to detach)
+    void setInput(Input* input) { m_input = input; }
+
     /// Get required Vulkan instance extensions for GLFW surface creation
     /// @param count Output parameter for extension count
     /// @return Array of extension name strings
@@ -69,10 +98,21 @@ private:
     /// GLFW framebuffer resize callback
     static void framebufferResizeCallback(GLFWwindow* window, int width, int height);
 
+    /// GLFW input and window event callbacks, all of which flag activity
+    static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+    static void cursorPosCallback(GLFWwindow* window, double x, double y);
+    static void scrollCallback(GLFWwindow* window, double xOffset, double yOffset);
+    static void refreshCallback(GLFWwindow* window);
+    static void focusCallback(GLFWwindow* window, int focused);
+    static Window* markActivity(GLFWwindow* window);
+
     GLFWwindow* m_window = nullptr;
     uint32_t m_width = 0;
     uint32_t m_height = 0;
     bool m_framebufferResized = false;
+    bool m_activity = false;
+    Input* m_input = nullptr;
 };
 
 } // namespace ct
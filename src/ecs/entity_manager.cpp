@@ -0,0 +1,67 @@
+#include "ecs/entity_manager.h"
+
+#include <atomic>
+
+namespace ct {
+
+uint32_t EntityManager::nextComponentTypeId() {
+    static std::atomic<uint32_t> next{0};
+    return next++;
+}
+
+Entity EntityManager::create() {
+    uint32_t index;
+    if (!m_freeIndices.empty()) {
+        index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    } else {
+        if (m_generations.size() >= Entity::kIndexMask) {  // The last index is reserved for kInvalidId
+            return {};
+        }
+        index = static_cast<uint32_t>(m_generations.size());
+        m_generations.push_back(0);
+        m_alive.push_back(0);
+    }
+
+    m_alive[index] = 1;
+    return {(static_cast<uint32_t>(m_generations[index]) << Entity::kIndexBits) | index};
+}
+
+void EntityManager::createBatch(size_t count, std::vector<Entity>& entities) {
+    entities.reserve(entities.size() + count);
+    m_generations.reserve(m_generations.size() + count);
+    m_alive.reserve(m_alive.size() + count);
+
+    for (size_t i = 0; i < count; i++) {
+        const Entity entity = create();
+        if (!entity.isValid()) {
+            return;
+        }
+        entities.push_back(entity);
+    }
+}
+
+void EntityManager::destroy(Entity entity) {
+    if (!isAlive(entity)) {
+        return;
+    }
+
+    for (auto& pool : m_pools) {
+        if (pool) {
+            pool->remove(entity);
+        }
+    }
+
+    const uint32_t index = entity.getIndex();
+    m_alive[index] = 0;
+    m_generations[index]++;  // Wraps after 256 reuses
+    m_freeIndices.push_back(index);
+}
+
+bool EntityManager::isAlive(Entity entity) const {
+    const uint32_t index = entity.getIndex();
+    return entity.isValid() && index < m_generations.size() && m_alive[index]
+        && m_generations[index] == entity.getGeneration();
+}
+
+} // namespace ct
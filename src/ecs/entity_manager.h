@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ct {
+
+/// Handle to an entity: slot index in the low 24 bits, generation in the high 8
+/// A destroyed entity's slot is reused with a new generation, so stale handles are detected
+struct Entity {
+    static constexpr uint32_t kIndexBits = 24;
+    static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+    static constexpr uint32_t kInvalidId = std::numeric_limits<uint32_t>::max();
+
+    uint32_t id = kInvalidId;
+
+    [[nodiscard]] uint32_t getIndex() const { return id & kIndexMask; }
+    [[nodiscard]] uint32_t getGeneration() const { return id >> kIndexBits; }
+    [[nodiscard]] bool isValid() const { return id != kInvalidId; }
+
+    bool operator==(const Entity&) const = default;
+};
+
+/// Type-erased interface to a component pool
+class ComponentPoolBase {
+public:
+    virtual ~ComponentPoolBase() = default;
+
+    /// Drop the entity's component if it has one
+    virtual void remove(Entity entity) = 0;
+};
+
+/// Sparse-set storage for one component type
+/// Components are packed densely for cache-friendly iteration; removal swaps with the last element.
+/// Lookups compare the full handle, so a stale handle never reaches a reused slot's component.
+template <typename T>
+class ComponentPool : public ComponentPoolBase {
+public:
+    static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+    /// Add or replace the entity's component
+    /// @return Component, or nullptr if the slot belongs to another generation (stale handle)
+    T* add(Entity entity, T component) {
+        const uint32_t index = entity.getIndex();
+        if (index >= m_sparse.size()) {
+            m_sparse.resize(index + 1, kNone);
+        }
+        if (m_sparse[index] != kNone) {
+            if (m_entities[m_sparse[index]] != entity) {
+                return nullptr;
+            }
+            m_components[m_sparse[index]] = std::move(component);
+            return &m_components[m_sparse[index]];
+        }
+        m_sparse[index] = static_cast<uint32_t>(m_entities.size());
+        m_entities.push_back(entity);
+        m_components.push_back(std::move(component));
+        return &m_components.back();
+    }
+
+    void remove(Entity entity) override {
+        const uint32_t slot = findSlot(entity);
+        if (slot == kNone) {
+            return;
+        }
+        const uint32_t last = static_cast<uint32_t>(m_entities.size() - 1);
+        if (slot != last) {
+            m_entities[slot] = m_entities[last];
+            m_components[slot] = std::move(m_components[last]);
+            m_sparse[m_entities[slot].getIndex()] = slot;
+        }
+        m_entities.pop_back();
+        m_components.pop_back();
+        m_sparse[entity.getIndex()] = kNone;
+    }
+
+    [[nodiscard]] T* get(Entity entity) {
+        const uint32_t slot = findSlot(entity);
+        return slot != kNone ? &m_components[slot] : nullptr;
+    }
+
+    /// Reserve dense storage ahead of a bulk insert
+    void reserve(size_t count) {
+        m_entities.reserve(count);
+        m_components.reserve(count);
+    }
+
+    [[nodiscard]] size_t size() const { return m_entities.size(); }
+    [[nodiscard]] std::vector<Entity>& getEntities() { return m_entities; }
+    [[nodiscard]] std::vector<T>& getComponents() { return m_components; }
+
+private:
+    /// Dense slot holding this exact handle, or kNone
+    [[nodiscard]] uint32_t findSlot(Entity entity) const {
+        const uint32_t index = entity.getIndex();
+        if (index >= m_sparse.size() || m_sparse[index] == kNone) {
+            return kNone;
+        }
+        return m_entities[m_sparse[index]] == entity ? m_sparse[index] : kNone;
+    }
+
+    std::vector<uint32_t> m_sparse;     // Entity index -> dense slot
+    std::vector<Entity> m_entities;
+    std::vector<T> m_components;
+};
+
+/// Owns entity lifetimes and their components
+class EntityManager {
+public:
+    EntityManager() = default;
+
+    // Non-copyable
+    EntityManager(const EntityManager&) = delete;
+    EntityManager& operator=(const EntityManager&) = delete;
+
+    /// Create an entity
+    /// @return New entity, or an invalid handle if all 2^24 slots are in use
+    Entity create();
+
+    /// Create many entities at once
+    /// @param count Number of entities
+    /// @param entities Receives the new handles
+    void createBatch(size_t count, std::vector<Entity>& entities);
+
+    /// Destroy an entity and all of its components (stale handles are ignored)
+    void destroy(Entity entity);
+
+    /// Check whether a handle refers to a live entity
+    [[nodiscard]] bool isAlive(Entity entity) const;
+
+    /// Get the number of live entities
+    [[nodiscard]] size_t getAliveCount() const { return m_generations.size() - m_freeIndices.size(); }
+
+    /// Attach a component, replacing any existing one of the same type
+    /// @return Component, or nullptr if the entity is not alive
+    template <typename T>
+    T* addComponent(Entity entity, T component = {}) {
+        if (!isAlive(entity)) {
+            return nullptr;
+        }
+        return getPool<T>().add(entity, std::move(component));
+    }
+
+    /// Get an entity's component
+    /// @return Component, or nullptr if the entity has none of this type
+    template <typename T>
+    [[nodiscard]] T* getComponent(Entity entity) {
+        return getPool<T>().get(entity);
+    }
+
+    template <typename T>
+    void removeComponent(Entity entity) {
+        getPool<T>().remove(entity);
+    }
+
+    /// Call fn(Entity, T&) for every entity with a T, in dense storage order
+    template <typename T, typename Fn>
+    void each(Fn&& fn) {
+        ComponentPool<T>& pool = getPool<T>();
+        std::vector<Entity>& entities = pool.getEntities();
+        std::vector<T>& components = pool.getComponents();
+        for (size_t i = 0; i < entities.size(); i++) {
+            fn(entities[i], components[i]);
+        }
+    }
+
+    /// Get the pool for a component type, creating it on first use
+    template <typename T>
+    ComponentPool<T>& getPool() {
+        const uint32_t type = getComponentTypeId<T>();
+        if (type >= m_pools.size()) {
+            m_pools.resize(type + 1);
+        }
+        if (!m_pools[type]) {
+            m_pools[type] = std::make_unique<ComponentPool<T>>();
+        }
+        return static_cast<ComponentPool<T>&>(*m_pools[type]);
+    }
+
+private:
+    /// Hand out dense ids to component types on first use
+    static uint32_t nextComponentTypeId();
+
+    template <typename T>
+    static uint32_t getComponentTypeId() {
+        static const uint32_t id = nextComponentTypeId();
+        return id;
+    }
+
+    std::vector<uint8_t> m_generations;                 // Per slot; bumped on destroy
+    std::vector<uint8_t> m_alive;
+    std::vector<uint32_t> m_freeIndices;
+    std::vector<std::unique_ptr<ComponentPoolBase>> m_pools;
+};
+
+} // namespace ct
@@ -0,0 +1,92 @@
+#include "rendering/gpu_frame_timer.h"
+#include "rendering/vulkan_context.h"
+
+#include <iostream>
+#include <vector>
+
+namespace ct {
+
+GpuFrameTimer::~GpuFrameTimer() {
+    shutdown();
+}
+
+bool GpuFrameTimer::initialize(const VulkanContext& context, uint32_t framesInFlight) {
+    shutdown();
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(context.getPhysicalDevice(), &properties);
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(context.getPhysicalDevice(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(context.getPhysicalDevice(), &familyCount, families.data());
+
+    const uint32_t validBits = families[context.getQueueFamilyIndices().graphicsFamily.value()].timestampValidBits;
+    if (validBits == 0 || properties.limits.timestampPeriod <= 0.0f) {
+        std::cerr << "GPU timestamps are not supported on the graphics queue\n";
+        return false;
+    }
+
+    VkQueryPoolCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    createInfo.queryCount = framesInFlight * 2;
+
+    VkResult result = vkCreateQueryPool(context.getDevice(), &createInfo, nullptr, &m_queryPool);
+    if (result != VK_SUCCESS) {
+        std::cerr << "Failed to create timestamp query pool! Error: " << result << "\n";
+        return false;
+    }
+
+    m_device = context.getDevice();
+    m_framesInFlight = framesInFlight;
+    m_nanosecondsPerTick = static_cast<double>(properties.limits.timestampPeriod);
+    m_validMask = validBits >= 64 ? ~uint64_t{0} : (uint64_t{1} << validBits) - 1;
+    return true;
+}
+
+void GpuFrameTimer::shutdown() {
+    if (m_queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(m_device, m_queryPool, nullptr);
+        m_queryPool = VK_NULL_HANDLE;
+    }
+    m_device = VK_NULL_HANDLE;
+    m_framesInFlight = 0;
+}
+
+void GpuFrameTimer::begin(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    if (m_queryPool == VK_NULL_HANDLE) {
+        return;
+    }
+    const uint32_t first = (frameIndex % m_framesInFlight) * 2;
+    vkCmdResetQueryPool(commandBuffer, m_queryPool, first, 2);
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, first);
+}
+
+void GpuFrameTimer::end(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    if (m_queryPool == VK_NULL_HANDLE) {
+        return;
+    }
+    const uint32_t first = (frameIndex % m_framesInFlight) * 2;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, first + 1);
+}
+
+bool GpuFrameTimer::resolve(uint32_t frameIndex, double& milliseconds) const {
+    if (m_queryPool == VK_NULL_HANDLE) {
+        return false;
+    }
+
+    uint64_t timestamps[2] = {};
+    const uint32_t first = (frameIndex % m_framesInFlight) * 2;
+    const VkResult result = vkGetQueryPoolResults(m_device, m_queryPool, first, 2, sizeof(timestamps), timestamps,
+                                                  sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) {
+        return false;  // VK_NOT_READY until the frame has executed
+    }
+
+    const uint64_t ticks = ((timestamps[1] & m_validMask) - (timestamps[0] & m_validMask)) & m_validMask;
+    milliseconds = static_cast<double>(ticks) * m_nanosecondsPerTick / 1e6;
+    return true;
+}
+
+} // namespace ct
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+
+namespace ct {
+
+class VulkanContext;
+
+/// Measures GPU time per frame with a pair of timestamp queries per frame in flight
+class GpuFrameTimer {
+public:
+    GpuFrameTimer() = default;
+    ~GpuFrameTimer();
+
+    // Non-copyable
+    GpuFrameTimer(const GpuFrameTimer&) = delete;
+    GpuFrameTimer& operator=(const GpuFrameTimer&) = delete;
+
+    /// Create the query pool
+    /// @param context Initialized Vulkan context
+    /// @param framesInFlight Number of frames that can be recorded before one is resolved
+    /// @return true if the graphics queue supports timestamps and the pool was created
+    bool initialize(const VulkanContext& context, uint32_t framesInFlight);
+
+    /// Destroy the query pool
+    void shutdown();
+
+    /// Reset the frame's queries and write the start timestamp (outside a render pass)
+    void begin(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+    /// Write the end timestamp once all of the frame's work has been recorded
+    void end(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+    /// Read a frame's GPU time without blocking (call after its fence signalled)
+    /// @return true if both timestamps were available
+    bool resolve(uint32_t frameIndex, double& milliseconds) const;
+
+private:
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkQueryPool m_queryPool = VK_NULL_HANDLE;
+    uint32_t m_framesInFlight = 0;
+    double m_nanosecondsPerTick = 1.0;
+    uint64_t m_validMask = ~uint64_t{0};
+};
+
+} // namespace ct
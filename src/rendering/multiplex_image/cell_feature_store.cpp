@@ -0,0 +1,446 @@
+#include "rendering/multiplex_image/cell_feature_store.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CT_FEATURE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace ct {
+
+namespace {
+
+template <CompareOp Op>
+bool compareScalar(float value, float threshold) {
+    if constexpr (Op == CompareOp::Less) {
+        return value < threshold;
+    } else if constexpr (Op == CompareOp::LessEqual) {
+        return value <= threshold;
+    } else if constexpr (Op == CompareOp::Greater) {
+        return value > threshold;
+    } else if constexpr (Op == CompareOp::GreaterEqual) {
+        return value >= threshold;
+    } else if constexpr (Op == CompareOp::Equal) {
+        return value == threshold;
+    } else {
+        return value != threshold;
+    }
+}
+
+#if CT_FEATURE_SSE2
+template <CompareOp Op>
+__m128 compareVector(__m128 values, __m128 threshold) {
+    if constexpr (Op == CompareOp::Less) {
+        return _mm_cmplt_ps(values, threshold);
+    } else if constexpr (Op == CompareOp::LessEqual) {
+        return _mm_cmple_ps(values, threshold);
+    } else if constexpr (Op == CompareOp::Greater) {
+        return _mm_cmpgt_ps(values, threshold);
+    } else if constexpr (Op == CompareOp::GreaterEqual) {
+        return _mm_cmpge_ps(values, threshold);
+    } else if constexpr (Op == CompareOp::Equal) {
+        return _mm_cmpeq_ps(values, threshold);
+    } else {
+        return _mm_cmpneq_ps(values, threshold);
+    }
+}
+#endif
+
+/// Evaluate value <op> threshold for every row, 64 rows per bitmap word
+/// @param intersect AND into the existing words (skipping empty ones) instead of overwriting
+template <CompareOp Op>
+void filterFloats(const float* values, size_t rowCount, float threshold, uint64_t* words, bool intersect) {
+    const size_t fullWords = rowCount / 64;
+    const size_t wordCount = (rowCount + 63) / 64;
+
+#if CT_FEATURE_SSE2
+    const __m128 thresholds = _mm_set1_ps(threshold);
+#endif
+
+    for (size_t word = 0; word < wordCount; word++) {
+        if (intersect && words[word] == 0) {
+            continue;
+        }
+
+        const float* block = values + word * 64;
+        uint64_t bits = 0;
+        if (word < fullWords) {
+#if CT_FEATURE_SSE2
+            // Columns are 4 KiB aligned in the file, so aligned loads are safe
+            for (uint32_t i = 0; i < 16; i++) {
+                const __m128 v = _mm_load_ps(block + i * 4);
+                const auto mask = static_cast<uint32_t>(_mm_movemask_ps(compareVector<Op>(v, thresholds)));
+                bits |= static_cast<uint64_t>(mask) << (i * 4);
+            }
+#else
+            for (uint32_t i = 0; i < 64; i++) {
+                bits |= static_cast<uint64_t>(compareScalar<Op>(block[i], threshold)) << i;
+            }
+#endif
+        } else {
+            for (size_t i = 0; i < rowCount - word * 64; i++) {
+                bits |= static_cast<uint64_t>(compareScalar<Op>(block[i], threshold)) << i;
+            }
+        }
+
+        words[word] = intersect ? words[word] & bits : bits;
+    }
+}
+
+/// Evaluate code == target (or !=) for every row, 64 rows per bitmap word
+void filterCodes(const uint16_t* codes, size_t rowCount, uint16_t target, bool equal, uint64_t* words,
+                 bool intersect) {
+    const size_t fullWords = rowCount / 64;
+    const size_t wordCount = (rowCount + 63) / 64;
+
+#if CT_FEATURE_SSE2
+    const __m128i targets = _mm_set1_epi16(static_cast<short>(target));
+#endif
+
+    for (size_t word = 0; word < wordCount; word++) {
+        if (intersect && words[word] == 0) {
+            continue;
+        }
+
+        const uint16_t* block = codes + word * 64;
+        const size_t count = word < fullWords ? 64 : rowCount - word * 64;
+        uint64_t bits = 0;
+#if CT_FEATURE_SSE2
+        if (count == 64) {
+            for (uint32_t i = 0; i < 4; i++) {
+                const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+                const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(block + i * 16 + 8));
+                // Pack the 16-bit lane masks to bytes so movemask yields one bit per row
+                const __m128i packed = _mm_packs_epi16(_mm_cmpeq_epi16(a, targets), _mm_cmpeq_epi16(b, targets));
+                const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(packed));
+                bits |= static_cast<uint64_t>(mask) << (i * 16);
+            }
+        } else
+#endif
+        {
+            for (size_t i = 0; i < count; i++) {
+                bits |= static_cast<uint64_t>(block[i] == target) << i;
+            }
+        }
+
+        if (!equal) {
+            bits = count == 64 ? ~bits : ~bits & ((uint64_t{1} << count) - 1);
+        }
+        words[word] = intersect ? words[word] & bits : bits;
+    }
+}
+
+std::string trim(const std::string& text) {
+    const size_t first = text.find_first_not_of(" \t");
+    if (first == std::string::npos) {
+        return {};
+    }
+    const size_t last = text.find_last_not_of(" \t");
+    return text.substr(first, last - first + 1);
+}
+
+} // namespace
+
+void RowBitmap::reset(size_t rowCount, bool value) {
+    m_rowCount = rowCount;
+    m_words.assign((rowCount + 63) / 64, value ? ~uint64_t{0} : 0);
+    if (value && rowCount % 64 != 0) {
+        m_words.back() = (uint64_t{1} << (rowCount % 64)) - 1;
+    }
+}
+
+size_t RowBitmap::count() const {
+    size_t total = 0;
+    for (uint64_t word : m_words) {
+        total += static_cast<size_t>(std::popcount(word));
+    }
+    return total;
+}
+
+void RowBitmap::intersect(const RowBitmap& other) {
+    for (size_t i = 0; i < m_words.size() && i < other.m_words.size(); i++) {
+        m_words[i] &= other.m_words[i];
+    }
+}
+
+void RowBitmap::unite(const RowBitmap& other) {
+    for (size_t i = 0; i < m_words.size() && i < other.m_words.size(); i++) {
+        m_words[i] |= other.m_words[i];
+    }
+}
+
+bool CellFeatureStore::open(const std::filesystem::path& path) {
+    close();
+
+    if (!m_file.open(path)) {
+        return false;
+    }
+
+    const uint8_t* base = m_file.getData();
+    const size_t size = m_file.getSize();
+
+    FeatureFileHeader header{};
+    if (size < sizeof(header)) {
+        std::cerr << "Failed to open feature store (truncated header): " << path << "\n";
+        close();
+        return false;
+    }
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kFeatureFileMagic, sizeof(kFeatureFileMagic)) != 0
+        || header.version != kFeatureFileVersion
+        || sizeof(header) + static_cast<uint64_t>(header.columnCount) * sizeof(FeatureColumnEntry) > size) {
+        std::cerr << "Failed to open feature store (bad header): " << path << "\n";
+        close();
+        return false;
+    }
+
+    m_rowCount = header.rowCount;
+    for (uint32_t i = 0; i < header.columnCount; i++) {
+        FeatureColumnEntry entry{};
+        std::memcpy(&entry, base + sizeof(header) + i * sizeof(FeatureColumnEntry), sizeof(entry));
+        entry.name[sizeof(entry.name) - 1] = '\0';
+
+        const auto type = static_cast<FeatureColumnType>(entry.type);
+        const bool knownType = type == FeatureColumnType::UInt32 || type == FeatureColumnType::Float32
+            || type == FeatureColumnType::Category;
+        if (!knownType || entry.offset % kFeatureColumnAlignment != 0
+            || entry.offset + header.rowCount * getFeatureElementSize(type) > size) {
+            std::cerr << "Failed to open feature store (bad column " << entry.name << "): " << path << "\n";
+            close();
+            return false;
+        }
+
+        Column column;
+        column.name = entry.name;
+        column.type = type;
+        column.data = base + entry.offset;
+
+        // Dictionaries are small; copy them out so lookups do not scan the mapping
+        if (type == FeatureColumnType::Category) {
+            const char* cursor = reinterpret_cast<const char*>(base + std::min<uint64_t>(entry.dictionaryOffset, size));
+            const char* end = reinterpret_cast<const char*>(base + size);
+            for (uint32_t d = 0; d < entry.dictionaryCount; d++) {
+                const char* terminator = std::find(cursor, end, '\0');
+                if (terminator == end) {
+                    std::cerr << "Failed to open feature store (bad dictionary for " << entry.name << "): " << path << "\n";
+                    close();
+                    return false;
+                }
+                column.dictionary.emplace_back(cursor, terminator);
+                cursor = terminator + 1;
+            }
+        }
+
+        m_columns.push_back(std::move(column));
+    }
+
+    if (!getLabels()) {
+        std::cerr << "Failed to open feature store (no label column): " << path << "\n";
+        close();
+        return false;
+    }
+
+    std::cout << "Feature store opened: " << m_rowCount << " rows, " << m_columns.size() << " columns\n";
+    return true;
+}
+
+void CellFeatureStore::close() {
+    m_columns.clear();
+    m_rowCount = 0;
+    m_file.close();
+}
+
+const uint32_t* CellFeatureStore::getLabels() const {
+    const Column* column = findColumn("label");
+    return column && column->type == FeatureColumnType::UInt32
+        ? reinterpret_cast<const uint32_t*>(column->data) : nullptr;
+}
+
+const float* CellFeatureStore::getFloatColumn(const std::string& name) const {
+    const Column* column = findColumn(name);
+    return column && column->type == FeatureColumnType::Float32
+        ? reinterpret_cast<const float*>(column->data) : nullptr;
+}
+
+const uint16_t* CellFeatureStore::getCategoryColumn(const std::string& name,
+                                                    const std::vector<std::string>** dictionary) const {
+    const Column* column = findColumn(name);
+    if (!column || column->type != FeatureColumnType::Category) {
+        return nullptr;
+    }
+    if (dictionary) {
+        *dictionary = &column->dictionary;
+    }
+    return reinterpret_cast<const uint16_t*>(column->data);
+}
+
+bool CellFeatureStore::parseQuery(const std::string& expression, std::vector<FeaturePredicate>& predicates) const {
+    static constexpr struct {
+        const char* text;
+        CompareOp op;
+    } kOperators[] = {
+        // Two-character operators first so "<=" is not read as "<"
+        {"<=", CompareOp::LessEqual}, {">=", CompareOp::GreaterEqual},
+        {"==", CompareOp::Equal}, {"!=", CompareOp::NotEqual},
+        {"<", CompareOp::Less}, {">", CompareOp::Greater},
+    };
+
+    size_t begin = 0;
+    while (begin <= expression.size()) {
+        size_t end = expression.find("&&", begin);
+        if (end == std::string::npos) {
+            end = expression.size();
+        }
+        const std::string clause = expression.substr(begin, end - begin);
+        begin = end + 2;
+
+        FeaturePredicate predicate;
+        size_t position = std::string::npos;
+        size_t length = 0;
+        for (const auto& candidate : kOperators) {
+            position = clause.find(candidate.text);
+            if (position != std::string::npos) {
+                predicate.op = candidate.op;
+                length = std::strlen(candidate.text);
+                break;
+            }
+        }
+        if (position == std::string::npos) {
+            std::cerr << "Failed to parse query clause (no operator): " << clause << "\n";
+            return false;
+        }
+
+        predicate.column = trim(clause.substr(0, position));
+        const std::string value = trim(clause.substr(position + length));
+        const Column* column = findColumn(predicate.column);
+        if (!column || value.empty()) {
+            std::cerr << "Failed to parse query clause (unknown column or missing value): " << clause << "\n";
+            return false;
+        }
+
+        if (column->type == FeatureColumnType::Category) {
+            predicate.category = value;
+        } else {
+            char* parsed = nullptr;
+            predicate.value = std::strtof(value.c_str(), &parsed);
+            if (parsed != value.c_str() + value.size()) {
+                std::cerr << "Failed to parse query clause (bad number): " << clause << "\n";
+                return false;
+            }
+        }
+        predicates.push_back(std::move(predicate));
+    }
+
+    return true;
+}
+
+bool CellFeatureStore::select(const std::vector<FeaturePredicate>& predicates, RowBitmap& rows) const {
+    rows.reset(m_rowCount, true);
+    uint64_t* words = rows.getWords().data();
+
+    for (size_t i = 0; i < predicates.size(); i++) {
+        const FeaturePredicate& predicate = predicates[i];
+        const Column* column = findColumn(predicate.column);
+        if (!column || column->type == FeatureColumnType::UInt32) {
+            std::cerr << "Cannot filter on column: " << predicate.column << "\n";
+            return false;
+        }
+
+        const bool intersect = i > 0;
+        if (column->type == FeatureColumnType::Category) {
+            if (predicate.op != CompareOp::Equal && predicate.op != CompareOp::NotEqual) {
+                std::cerr << "Category column " << predicate.column << " only supports == and !=\n";
+                return false;
+            }
+
+            // A value missing from the dictionary matches no row
+            const auto found = std::find(column->dictionary.begin(), column->dictionary.end(), predicate.category);
+            const auto code = found == column->dictionary.end()
+                ? CellComponent::kNoCellType
+                : static_cast<uint16_t>(found - column->dictionary.begin());
+            filterCodes(reinterpret_cast<const uint16_t*>(column->data), m_rowCount, code,
+                        predicate.op == CompareOp::Equal, words, intersect);
+            continue;
+        }
+
+        const auto* values = reinterpret_cast<const float*>(column->data);
+        switch (predicate.op) {
+            case CompareOp::Less:
+                filterFloats<CompareOp::Less>(values, m_rowCount, predicate.value, words, intersect);
+                break;
+            case CompareOp::LessEqual:
+                filterFloats<CompareOp::LessEqual>(values, m_rowCount, predicate.value, words, intersect);
+                break;
+            case CompareOp::Greater:
+                filterFloats<CompareOp::Greater>(values, m_rowCount, predicate.value, words, intersect);
+                break;
+            case CompareOp::GreaterEqual:
+                filterFloats<CompareOp::GreaterEqual>(values, m_rowCount, predicate.value, words, intersect);
+                break;
+            case CompareOp::Equal:
+                filterFloats<CompareOp::Equal>(values, m_rowCount, predicate.value, words, intersect);
+                break;
+            case CompareOp::NotEqual:
+                filterFloats<CompareOp::NotEqual>(values, m_rowCount, predicate.value, words, intersect);
+                break;
+        }
+    }
+
+    return true;
+}
+
+bool CellFeatureStore::select(const std::string& expression, RowBitmap& rows) const {
+    std::vector<FeaturePredicate> predicates;
+    return parseQuery(expression, predicates) && select(predicates, rows);
+}
+
+size_t CellFeatureStore::spawnEntities(const RowBitmap& rows, EntityManager& entities,
+                                       std::vector<Entity>* spawned) const {
+    const uint32_t* labels = getLabels();
+    const float* centroidX = getFloatColumn("centroid_x");
+    const float* centroidY = getFloatColumn("centroid_y");
+    const uint16_t* cellTypes = getCategoryColumn("cell_type");
+
+    std::vector<Entity> created;
+    entities.createBatch(rows.count(), created);
+
+    ComponentPool<CellComponent>& pool = entities.getPool<CellComponent>();
+    pool.reserve(pool.size() + created.size());
+
+    size_t next = 0;
+    rows.forEachSet([&](size_t row) {
+        if (next >= created.size() || row >= m_rowCount) {
+            return;
+        }
+        CellComponent cell;
+        cell.label = labels[row];
+        cell.row = static_cast<uint32_t>(row);
+        if (cellTypes) {
+            cell.cellType = cellTypes[row];
+        }
+        if (centroidX && centroidY) {
+            cell.position = glm::vec2(centroidX[row], centroidY[row]);
+        }
+        pool.add(created[next++], cell);
+    });
+
+    if (spawned) {
+        spawned->insert(spawned->end(), created.begin(), created.end());
+    }
+    return next;
+}
+
+const CellFeatureStore::Column* CellFeatureStore::findColumn(const std::string& name) const {
+    for (const Column& column : m_columns) {
+        if (column.name == name) {
+            return &column;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace ct
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "core/mapped_file.h"
+#include "ecs/entity_manager.h"
+#include "rendering/multiplex_image/cell_feature_table.h"
+
+#include <glm/glm.hpp>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace ct {
+
+/// One bit per table row
+class RowBitmap {
+public:
+    /// Size the bitmap and set every bit to value
+    void reset(size_t rowCount, bool value = false);
+
+    [[nodiscard]] size_t getRowCount() const { return m_rowCount; }
+    [[nodiscard]] bool test(size_t row) const { return (m_words[row / 64] >> (row % 64)) & 1u; }
+    void set(size_t row) { m_words[row / 64] |= uint64_t{1} << (row % 64); }
+
+    /// Count the set bits
+    [[nodiscard]] size_t count() const;
+
+    /// Keep only rows also set in other (same row count)
+    void intersect(const RowBitmap& other);
+
+    /// Add rows set in other (same row count)
+    void unite(const RowBitmap& other);
+
+    /// Call fn(row) for every set row in ascending order
+    template <typename Fn>
+    void forEachSet(Fn&& fn) const {
+        for (size_t word = 0; word < m_words.size(); word++) {
+            for (uint64_t bits = m_words[word]; bits != 0; bits &= bits - 1) {
+                fn(word * 64 + static_cast<size_t>(std::countr_zero(bits)));
+            }
+        }
+    }
+
+    [[nodiscard]] std::vector<uint64_t>& getWords() { return m_words; }
+    [[nodiscard]] const std::vector<uint64_t>& getWords() const { return m_words; }
+
+private:
+    std::vector<uint64_t> m_words;
+    size_t m_rowCount = 0;
+};
+
+/// Comparison used by a gating predicate
+enum class CompareOp : uint8_t {
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Equal,
+    NotEqual,
+};
+
+/// One comparison of a gating query, e.g. CD3_mean > 0.5 or cell_type == T_helper
+struct FeaturePredicate {
+    std::string column;
+    CompareOp op = CompareOp::Greater;
+    float value = 0.0f;             // Float columns
+    std::string category;           // Category columns (Equal and NotEqual only)
+};
+
+/// Attached to entities spawned from feature rows
+struct CellComponent {
+    static constexpr uint16_t kNoCellType = std::numeric_limits<uint16_t>::max();
+
+    uint32_t label = 0;             // Segmentation label
+    uint32_t row = 0;               // Row in the feature store
+    uint16_t cellType = kNoCellType; // Code in the cell_type dictionary
+    glm::vec2 position{0.0f};       // Centroid in image pixels
+};
+
+/// Read-only, memory-mapped view of a feature file (.ctfeat)
+///
+/// Columns stay in the page cache and are touched only when a query reads them. Queries are
+/// conjunctions of predicates evaluated column by column into a RowBitmap, 64 rows per word
+/// with SSE2 compares; words already cleared by an earlier predicate are skipped.
+class CellFeatureStore {
+public:
+    CellFeatureStore() = default;
+
+    // Non-copyable
+    CellFeatureStore(const CellFeatureStore&) = delete;
+    CellFeatureStore& operator=(const CellFeatureStore&) = delete;
+
+    /// Map a feature file and validate its column directory
+    /// @return true if the file was opened
+    bool open(const std::filesystem::path& path);
+
+    /// Unmap the file
+    void close();
+
+    [[nodiscard]] size_t getRowCount() const { return m_rowCount; }
+    [[nodiscard]] size_t getColumnCount() const { return m_columns.size(); }
+    [[nodiscard]] const std::string& getColumnName(size_t index) const { return m_columns[index].name; }
+
+    /// Get the label column
+    [[nodiscard]] const uint32_t* getLabels() const;
+
+    /// Get a float column
+    /// @return Column data, or nullptr if there is no float column with this name
+    [[nodiscard]] const float* getFloatColumn(const std::string& name) const;
+
+    /// Get the codes of a category column
+    /// @param dictionary Receives the column's dictionary (optional)
+    /// @return Column data, or nullptr if there is no category column with this name
+    [[nodiscard]] const uint16_t* getCategoryColumn(const std::string& name,
+                                                    const std::vector<std::string>** dictionary = nullptr) const;
+
+    /// Parse a query such as "CD3_mean > 200 && CD8_mean > 150 && CD4_mean < 50"
+    /// @return true if every clause names a known column with a valid operator and value
+    bool parseQuery(const std::string& expression, std::vector<FeaturePredicate>& predicates) const;
+
+    /// Select the rows matching every predicate
+    /// @return true if all predicates were valid
+    bool select(const std::vector<FeaturePredicate>& predicates, RowBitmap& rows) const;
+
+    /// Parse and run a query
+    bool select(const std::string& expression, RowBitmap& rows) const;
+
+    /// Create one entity per selected row with a CellComponent
+    /// Positions come from centroid_x/centroid_y and types from cell_type when those columns exist
+    /// @param spawned Receives the new entities in row order (optional)
+    /// @return Number of entities created
+    size_t spawnEntities(const RowBitmap& rows, EntityManager& entities, std::vector<Entity>* spawned = nullptr) const;
+
+private:
+    struct Column {
+        std::string name;
+        FeatureColumnType type = FeatureColumnType::Float32;
+        const uint8_t* data = nullptr;
+        std::vector<std::string> dictionary;
+    };
+
+    [[nodiscard]] const Column* findColumn(const std::string& name) const;
+
+    MappedFile m_file;
+    size_t m_rowCount = 0;
+    std::vector<Column> m_columns;
+};
+
+} // namespace ct
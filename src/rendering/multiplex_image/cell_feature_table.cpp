@@ -0,0 +1,131 @@
+#include "rendering/multiplex_image/cell_feature_table.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+
+namespace ct {
+
+namespace {
+
+uint64_t alignOffset(uint64_t offset) {
+    return (offset + kFeatureColumnAlignment - 1) / kFeatureColumnAlignment * kFeatureColumnAlignment;
+}
+
+} // namespace
+
+const FeatureColumn* CellFeatureTable::findColumn(const std::string& name) const {
+    for (const FeatureColumn& column : columns) {
+        if (column.name == name) {
+            return &column;
+        }
+    }
+    return nullptr;
+}
+
+bool CellFeatureTable::save(const std::filesystem::path& path) const {
+    const uint64_t rowCount = labels.size();
+    const auto columnCount = static_cast<uint32_t>(1 + columns.size() + categories.size());
+
+    // Column order: label, float columns, category columns
+    struct ColumnSource {
+        std::string name;
+        FeatureColumnType type;
+        const void* data;
+        size_t rows;
+        const std::vector<std::string>* dictionary;
+    };
+    std::vector<ColumnSource> sources;
+    sources.push_back({"label", FeatureColumnType::UInt32, labels.data(), labels.size(), nullptr});
+    for (const FeatureColumn& column : columns) {
+        sources.push_back({column.name, FeatureColumnType::Float32, column.values.data(), column.values.size(), nullptr});
+    }
+    for (const CategoryColumn& column : categories) {
+        sources.push_back({column.name, FeatureColumnType::Category, column.codes.data(), column.codes.size(),
+                           &column.dictionary});
+    }
+
+    std::vector<FeatureColumnEntry> entries(columnCount);
+    std::vector<std::string> dictionaryBlocks(columnCount);
+    uint64_t offset = alignOffset(sizeof(FeatureFileHeader) + columnCount * sizeof(FeatureColumnEntry));
+
+    for (uint32_t i = 0; i < columnCount; i++) {
+        const ColumnSource& source = sources[i];
+        if (source.name.size() >= sizeof(FeatureColumnEntry::name)) {
+            std::cerr << "Failed to save feature table: column name too long: " << source.name << "\n";
+            return false;
+        }
+        if (source.rows != rowCount) {
+            std::cerr << "Failed to save feature table: column " << source.name << " has " << source.rows
+                      << " rows, expected " << rowCount << "\n";
+            return false;
+        }
+
+        FeatureColumnEntry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        std::memcpy(entry.name, source.name.data(), source.name.size());
+        entry.type = static_cast<uint32_t>(source.type);
+        entry.offset = offset;
+        offset = alignOffset(offset + rowCount * getFeatureElementSize(source.type));
+
+        if (source.dictionary) {
+            for (const std::string& value : *source.dictionary) {
+                dictionaryBlocks[i].append(value).push_back('\0');
+            }
+            entry.dictionaryCount = static_cast<uint32_t>(source.dictionary->size());
+            entry.dictionaryOffset = offset;
+            offset = alignOffset(offset + dictionaryBlocks[i].size());
+        }
+    }
+
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Failed to create feature file: " << tempPath << "\n";
+        return false;
+    }
+
+    FeatureFileHeader header{};
+    std::memcpy(header.magic, kFeatureFileMagic, sizeof(kFeatureFileMagic));
+    header.version = kFeatureFileVersion;
+    header.columnCount = columnCount;
+    header.rowCount = rowCount;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()),
+               static_cast<std::streamsize>(entries.size() * sizeof(FeatureColumnEntry)));
+
+    for (uint32_t i = 0; i < columnCount; i++) {
+        const auto bytes = rowCount * getFeatureElementSize(sources[i].type);
+        file.seekp(static_cast<std::streamoff>(entries[i].offset));
+        file.write(static_cast<const char*>(sources[i].data), static_cast<std::streamsize>(bytes));
+        if (!dictionaryBlocks[i].empty()) {
+            file.seekp(static_cast<std::streamoff>(entries[i].dictionaryOffset));
+            file.write(dictionaryBlocks[i].data(), static_cast<std::streamsize>(dictionaryBlocks[i].size()));
+        }
+    }
+
+    // Pad to the aligned end so the last column can be mapped whole
+    file.seekp(static_cast<std::streamoff>(offset - 1));
+    file.put('\0');
+    file.close();
+
+    if (!file) {
+        std::cerr << "Failed to write feature file: " << tempPath << "\n";
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::cerr << "Failed to move feature file into place: " << path << " (" << ec.message() << ")\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace ct
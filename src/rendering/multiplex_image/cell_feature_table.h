@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace ct {
+
+/// Storage type of one column in a feature file
+enum class FeatureColumnType : uint32_t {
+    UInt32 = 0,
+    Float32 = 1,
+    Category = 2,               // uint16 codes into a string dictionary
+};
+
+/// On-disk layout of a feature file (.ctfeat)
+///
+/// A header, a directory of column entries, then one 4 KiB aligned array per column
+/// so every column can be mapped and scanned independently. Category columns are
+/// followed by their dictionary as consecutive null-terminated strings.
+struct FeatureFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t columnCount;
+    uint64_t rowCount;
+};
+
+struct FeatureColumnEntry {
+    char name[48];              // Null-terminated
+    uint32_t type;              // FeatureColumnType
+    uint32_t dictionaryCount;   // Category columns: number of dictionary strings
+    uint64_t offset;            // Byte offset of the column data
+    uint64_t dictionaryOffset;  // Category columns: byte offset of the dictionary
+};
+
+inline constexpr char kFeatureFileMagic[8] = {'C', 'T', 'F', 'E', 'A', 'T', '0', '1'};
+inline constexpr uint32_t kFeatureFileVersion = 2;
+inline constexpr uint64_t kFeatureColumnAlignment = 4096;
+
+/// Get the size of one element of a column type in bytes
+inline constexpr uint64_t getFeatureElementSize(FeatureColumnType type) {
+    return type == FeatureColumnType::Category ? sizeof(uint16_t) : 4;
+}
+
+/// One float column of a feature table
+struct FeatureColumn {
+    std::string name;
+    std::vector<float> values;
+};
+
+/// One dictionary-encoded column (e.g. cell type)
+struct CategoryColumn {
+    std::string name;
+    std::vector<uint16_t> codes;            // Index into dictionary, per row
+    std::vector<std::string> dictionary;
+};
+
+/// Per-cell features in columnar form: one row per cell, keyed by label
+struct CellFeatureTable {
+    std::vector<uint32_t> labels;
+    std::vector<FeatureColumn> columns;
+    std::vector<CategoryColumn> categories;
+
+    /// Find a column by name
+    /// @return Column, or nullptr if there is none
+    [[nodiscard]] const FeatureColumn* findColumn(const std::string& name) const;
+
+    /// Write the table as a feature file (labels are stored as the "label" column)
+    bool save(const std::filesystem::path& path) const;
+};
+
+} // namespace ct
@@ -0,0 +1,388 @@
+#include "rendering/multiplex_image/cell_quantifier.h"
+#include "core/job_system.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CT_QUANTIFY_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace ct {
+
+namespace {
+
+constexpr size_t kNoBorderValues = SIZE_MAX;
+
+/// Values kept per border cell and channel (32 bytes)
+constexpr size_t kSketchSize = 16;
+
+/// Runs of one cell within the tile being processed
+struct CellGroup {
+    uint32_t cell = 0;          // Index into SegmentationMask::getCells()
+    size_t firstRun = 0;
+    size_t endRun = 0;
+    uint32_t pixelCount = 0;
+    size_t scratchOffset = kNoBorderValues;     // Where a border cell's sorted values wait for the fold
+};
+
+/// Statistics for one cell and channel from a single tile
+struct BatchResult {
+    uint64_t sum = 0;
+    uint64_t sumSquares = 0;
+    float median = 0.0f;
+};
+
+/// Median of a batch, averaging the two middle values for even counts (reorders values)
+float batchMedian(uint16_t* values, size_t count) {
+    uint16_t* middle = values + count / 2;
+    std::nth_element(values, middle, values + count);
+    if (count % 2 != 0) {
+        return *middle;
+    }
+    const uint16_t lower = *std::max_element(values, middle);
+    return (static_cast<float>(lower) + static_cast<float>(*middle)) * 0.5f;
+}
+
+/// Fold one tile's sorted values into a cell's quantile sketch
+///
+/// The sketch holds kSketchSize values at evenly spaced ranks of the `previous` pixels folded
+/// so far, each standing in for previous / kSketchSize of them. Merging walks the sketch and
+/// the new values in order by weight. On the cell's last tile the median is read off the merge
+/// instead of rebuilding the sketch. Each rebuild moves ranks by at most half a sketch step, so
+/// the median's rank error is below area / 32 per tile after the first.
+/// @return Median once `last` is set, otherwise 0
+float foldSketch(uint16_t* sketch, uint64_t previous, const uint16_t* values, size_t count, bool last) {
+    const double sketchWeight = static_cast<double>(previous) / static_cast<double>(kSketchSize);
+    const double total = static_cast<double>(previous + count);
+    const size_t sketchCount = previous > 0 ? kSketchSize : 0;
+
+    std::array<uint16_t, kSketchSize> rebuilt{};
+    size_t target = 0;
+    double cumulative = 0.0;
+    size_t s = 0;
+    size_t v = 0;
+    while (s < sketchCount || v < count) {
+        const bool fromSketch = v == count || (s < sketchCount && sketch[s] <= values[v]);
+        const uint16_t value = fromSketch ? sketch[s++] : values[v++];
+        cumulative += fromSketch ? sketchWeight : 1.0;
+
+        if (last) {
+            if (cumulative >= total * 0.5) {
+                return value;
+            }
+            continue;
+        }
+        while (target < kSketchSize && cumulative >= (static_cast<double>(target) + 0.5) * total / kSketchSize) {
+            rebuilt[target++] = value;
+        }
+    }
+
+    // Rounding can leave the top ranks unfilled
+    for (; target < kSketchSize; target++) {
+        rebuilt[target] = target > 0 ? rebuilt[target - 1] : 0;
+    }
+    std::copy(rebuilt.begin(), rebuilt.end(), sketch);
+    return 0.0f;
+}
+
+} // namespace
+
+bool CellQuantifier::quantify(const SegmentationMask& mask, const ImageSource& image, CellFeatureTable& table) const {
+    const auto start = std::chrono::steady_clock::now();
+
+    if (mask.getWidth() != image.getWidth() || mask.getHeight() != image.getHeight()) {
+        std::cerr << "Failed to quantify cells: mask is " << mask.getWidth() << "x" << mask.getHeight()
+                  << " but image is " << image.getWidth() << "x" << image.getHeight() << "\n";
+        return false;
+    }
+
+    std::vector<uint32_t> channels = m_config.channels;
+    if (channels.empty()) {
+        for (uint32_t channel = 0; channel < image.getChannelCount(); channel++) {
+            channels.push_back(channel);
+        }
+    }
+    for (uint32_t channel : channels) {
+        if (channel >= image.getChannelCount()) {
+            std::cerr << "Failed to quantify cells: channel " << channel << " out of range\n";
+            return false;
+        }
+    }
+    if (!m_config.channelNames.empty() && m_config.channelNames.size() != channels.size()) {
+        std::cerr << "Failed to quantify cells: " << m_config.channelNames.size() << " channel names for "
+                  << channels.size() << " channels\n";
+        return false;
+    }
+
+    const std::vector<CellInfo>& cells = mask.getCells();
+    const size_t cellCount = cells.size();
+    const size_t channelCount = channels.size();
+    constexpr uint32_t tileSize = SegmentationMask::kTileSize;
+
+    // Channel-major accumulators so each output column is contiguous
+    std::vector<uint64_t> sums(channelCount * cellCount, 0);
+    std::vector<uint64_t> sumSquares(channelCount * cellCount, 0);
+    std::vector<float> medians(channelCount * cellCount, 0.0f);
+    std::vector<uint64_t> counts(cellCount, 0);
+
+    // Interior cells get an exact median from their only tile. Cells crossing a tile border
+    // carry a fixed-size quantile sketch per channel from tile to tile.
+    std::vector<size_t> borderOffsets(cellCount, kNoBorderValues);
+    size_t sketchValueCount = 0;
+    for (size_t i = 0; i < cellCount; i++) {
+        const CellInfo& cell = cells[i];
+        if (cell.minX / tileSize != cell.maxX / tileSize || cell.minY / tileSize != cell.maxY / tileSize) {
+            borderOffsets[i] = sketchValueCount;
+            sketchValueCount += kSketchSize * channelCount;
+        }
+    }
+    std::vector<uint16_t> sketches(sketchValueCount);
+
+    // Cells spanning three or more tiles in either axis can be reached by two tiles of the
+    // same phase; their updates go through a lock
+    std::vector<uint8_t> sharedCells(cellCount, 0);
+    for (size_t i = 0; i < cellCount; i++) {
+        const CellInfo& cell = cells[i];
+        sharedCells[i] = (cell.maxX / tileSize - cell.minX / tileSize >= 2
+                          || cell.maxY / tileSize - cell.minY / tileSize >= 2) ? 1u : 0u;
+    }
+    std::mutex sharedMutex;
+
+    std::atomic<bool> failed{false};
+    std::atomic<uint64_t> tilesRead{0};
+
+    JobSystem jobs;
+    jobs.initialize(m_config.threadCount);
+
+    for (uint32_t phase = 0; phase < 4 && !failed; phase++) {
+        std::vector<std::pair<uint32_t, uint32_t>> tiles;
+        for (uint32_t tileY = phase / 2; tileY < mask.getTilesY(); tileY += 2) {
+            for (uint32_t tileX = phase % 2; tileX < mask.getTilesX(); tileX += 2) {
+                tiles.emplace_back(tileX, tileY);
+            }
+        }
+
+        jobs.parallelFor(tiles.size(), 1, [&](size_t begin, size_t end) {
+            std::vector<LabelRun> runs;
+            std::vector<CellGroup> groups;
+            std::vector<BatchResult> results;
+            std::vector<uint16_t> pixels(static_cast<size_t>(tileSize) * tileSize);
+            std::vector<uint16_t> values;
+            std::vector<uint16_t> borderScratch;
+
+            for (size_t index = begin; index < end && !failed; index++) {
+                const auto [tileX, tileY] = tiles[index];
+
+                runs.clear();
+                mask.getTileRuns(tileX, tileY, runs);
+                if (runs.empty()) {
+                    continue;  // Background only: no channel reads needed
+                }
+
+                std::stable_sort(runs.begin(), runs.end(),
+                                 [](const LabelRun& a, const LabelRun& b) { return a.label < b.label; });
+
+                groups.clear();
+                size_t scratchSize = 0;
+                for (size_t run = 0; run < runs.size();) {
+                    CellGroup group;
+                    group.firstRun = run;
+                    const CellInfo* cell = mask.findCell(runs[run].label);
+                    group.cell = static_cast<uint32_t>(cell - cells.data());
+                    while (run < runs.size() && runs[run].label == runs[group.firstRun].label) {
+                        group.pixelCount += runs[run].length;
+                        run++;
+                    }
+                    group.endRun = run;
+                    if (borderOffsets[group.cell] != kNoBorderValues) {
+                        group.scratchOffset = scratchSize;
+                        scratchSize += static_cast<size_t>(group.pixelCount) * channelCount;
+                    }
+                    groups.push_back(group);
+                }
+                borderScratch.resize(scratchSize);
+
+                const uint32_t x0 = tileX * tileSize;
+                const uint32_t y0 = tileY * tileSize;
+                const uint32_t width = std::min(tileSize, image.getWidth() - x0);
+                const uint32_t height = std::min(tileSize, image.getHeight() - y0);
+
+                results.assign(groups.size() * channelCount, {});
+                for (size_t c = 0; c < channelCount; c++) {
+                    if (!image.readRegion(channels[c], x0, y0, width, height, pixels.data(), tileSize)) {
+                        failed = true;
+                        return;
+                    }
+                    tilesRead++;
+
+                    for (size_t g = 0; g < groups.size(); g++) {
+                        const CellGroup& group = groups[g];
+                        values.resize(group.pixelCount);
+
+                        size_t cursor = 0;
+                        for (size_t run = group.firstRun; run < group.endRun; run++) {
+                            const LabelRun& labelRun = runs[run];
+                            std::memcpy(values.data() + cursor,
+                                        pixels.data() + static_cast<size_t>(labelRun.y) * tileSize + labelRun.x,
+                                        labelRun.length * sizeof(uint16_t));
+                            cursor += labelRun.length;
+                        }
+
+                        BatchResult& result = results[g * channelCount + c];
+                        accumulate(values.data(), values.size(), result.sum, result.sumSquares);
+                        if (group.scratchOffset == kNoBorderValues) {
+                            result.median = batchMedian(values.data(), values.size());
+                        } else {
+                            uint16_t* sorted = borderScratch.data() + group.scratchOffset + c * group.pixelCount;
+                            std::memcpy(sorted, values.data(), values.size() * sizeof(uint16_t));
+                            std::sort(sorted, sorted + values.size());
+                        }
+                    }
+                }
+
+                // Fold this tile into the totals
+                for (size_t g = 0; g < groups.size(); g++) {
+                    const CellGroup& group = groups[g];
+                    std::unique_lock<std::mutex> lock(sharedMutex, std::defer_lock);
+                    if (sharedCells[group.cell]) {
+                        lock.lock();
+                    }
+
+                    const uint64_t previous = counts[group.cell];
+                    if (previous + group.pixelCount > cells[group.cell].area) {
+                        failed = true;  // Runs disagree with the cell table
+                        return;
+                    }
+                    const bool lastTile = previous + group.pixelCount == cells[group.cell].area;
+
+                    for (size_t c = 0; c < channelCount; c++) {
+                        const BatchResult& result = results[g * channelCount + c];
+                        const size_t slot = c * cellCount + group.cell;
+                        sums[slot] += result.sum;
+                        sumSquares[slot] += result.sumSquares;
+                        if (group.scratchOffset == kNoBorderValues) {
+                            medians[slot] = result.median;
+                        } else {
+                            const float median = foldSketch(
+                                sketches.data() + borderOffsets[group.cell] + c * kSketchSize, previous,
+                                borderScratch.data() + group.scratchOffset + c * group.pixelCount, group.pixelCount,
+                                lastTile);
+                            if (lastTile) {
+                                medians[slot] = median;
+                            }
+                        }
+                    }
+                    counts[group.cell] += group.pixelCount;
+                }
+            }
+        });
+    }
+
+    jobs.shutdown();
+
+    if (failed) {
+        std::cerr << "Failed to read image tiles for quantification\n";
+        return false;
+    }
+
+    table.labels.resize(cellCount);
+    table.columns.clear();
+    table.columns.reserve(3 + channelCount * 3);
+
+    const auto addColumn = [&](std::string name) -> std::vector<float>& {
+        table.columns.push_back({std::move(name), std::vector<float>(cellCount)});
+        return table.columns.back().values;
+    };
+
+    std::vector<float>& area = addColumn("area");
+    std::vector<float>& centroidX = addColumn("centroid_x");
+    std::vector<float>& centroidY = addColumn("centroid_y");
+    for (size_t i = 0; i < cellCount; i++) {
+        table.labels[i] = cells[i].label;
+        area[i] = static_cast<float>(cells[i].area);
+        centroidX[i] = cells[i].centroid.x;
+        centroidY[i] = cells[i].centroid.y;
+    }
+
+    for (size_t c = 0; c < channelCount; c++) {
+        const std::string name = m_config.channelNames.empty()
+            ? "channel" + std::to_string(channels[c]) : m_config.channelNames[c];
+        std::vector<float>& mean = addColumn(name + "_mean");
+        std::vector<float>& stddev = addColumn(name + "_stddev");
+        std::vector<float>& median = addColumn(name + "_median");
+
+        for (size_t i = 0; i < cellCount; i++) {
+            const size_t slot = c * cellCount + i;
+            if (counts[i] == 0) {
+                continue;
+            }
+            const auto count = static_cast<double>(counts[i]);
+            const double average = static_cast<double>(sums[slot]) / count;
+            const double variance = static_cast<double>(sumSquares[slot]) / count - average * average;
+            mean[i] = static_cast<float>(average);
+            stddev[i] = static_cast<float>(std::sqrt(std::max(variance, 0.0)));
+            median[i] = medians[slot];
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Quantified " << cellCount << " cells x " << channelCount << " channels in " << seconds
+              << " s (" << tilesRead.load() << " channel tiles read once each)\n";
+    return true;
+}
+
+void CellQuantifier::accumulate(const uint16_t* values, size_t count, uint64_t& sum, uint64_t& sumSquares) {
+    size_t i = 0;
+    uint64_t total = 0;
+    uint64_t totalSquares = 0;
+
+#if CT_QUANTIFY_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum64 = zero;
+    __m128i squares64 = zero;
+
+    for (; i + 8 <= count; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        const __m128i lo = _mm_unpacklo_epi16(v, zero);
+        const __m128i hi = _mm_unpackhi_epi16(v, zero);
+
+        // Pairwise 32-bit sums cannot overflow; widen to 64 bits before accumulating
+        const __m128i pairs = _mm_add_epi32(lo, hi);
+        sum64 = _mm_add_epi64(sum64, _mm_unpacklo_epi32(pairs, zero));
+        sum64 = _mm_add_epi64(sum64, _mm_unpackhi_epi32(pairs, zero));
+
+        // _mm_mul_epu32 squares the even 32-bit lanes into 64-bit products; shift for the odd ones
+        const __m128i loOdd = _mm_srli_epi64(lo, 32);
+        const __m128i hiOdd = _mm_srli_epi64(hi, 32);
+        squares64 = _mm_add_epi64(squares64, _mm_mul_epu32(lo, lo));
+        squares64 = _mm_add_epi64(squares64, _mm_mul_epu32(loOdd, loOdd));
+        squares64 = _mm_add_epi64(squares64, _mm_mul_epu32(hi, hi));
+        squares64 = _mm_add_epi64(squares64, _mm_mul_epu32(hiOdd, hiOdd));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum64);
+    total = lanes[0] + lanes[1];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), squares64);
+    totalSquares = lanes[0] + lanes[1];
+#endif
+
+    for (; i < count; i++) {
+        const uint64_t value = values[i];
+        total += value;
+        totalSquares += value * value;
+    }
+
+    sum += total;
+    sumSquares += totalSquares;
+}
+
+} // namespace ct
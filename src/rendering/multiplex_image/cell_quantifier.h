@@ -0,0 +1,45 @@
+#pragma once
+
+#include "rendering/multiplex_image/cell_feature_table.h"
+#include "rendering/multiplex_image/image_source.h"
+#include "rendering/multiplex_image/segmentation_mask.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ct {
+
+/// Configuration for per-cell marker quantification
+struct CellQuantifierConfig {
+    uint32_t threadCount = 0;                   // Worker threads (0 = all hardware threads)
+    std::vector<uint32_t> channels;             // Channels to quantify (empty = all)
+    std::vector<std::string> channelNames;      // Column prefixes, parallel to channels (empty = "channel<N>")
+};
+
+/// Computes per-cell intensity statistics for every channel in one pass over the image
+///
+/// Each mask tile is decoded once and every channel tile under it is read once. Tiles are
+/// processed in four checkerboard phases so cells crossing a tile border are never updated
+/// by two workers at the same time. Output columns per channel are <name>_mean,
+/// <name>_stddev and <name>_median. The median is exact for cells inside one tile. Cells
+/// crossing a tile border carry a 16-value quantile sketch per channel (32 bytes each), so
+/// their median is within a rank error of area / 32 per extra tile.
+class CellQuantifier {
+public:
+    explicit CellQuantifier(const CellQuantifierConfig& config = {}) : m_config(config) {}
+
+    /// Quantify every cell of a mask against a multiplex image of the same size
+    /// @param table Receives one row per cell: area, centroid_x, centroid_y, then per-channel columns
+    /// @return true if quantification succeeded
+    bool quantify(const SegmentationMask& mask, const ImageSource& image, CellFeatureTable& table) const;
+
+    /// Sum the values and their squares (SSE2 when available)
+    static void accumulate(const uint16_t* values, size_t count, uint64_t& sum, uint64_t& sumSquares);
+
+private:
+    CellQuantifierConfig m_config;
+};
+
+} // namespace ct
@@ -0,0 +1,440 @@
+#include "rendering/multiplex_image/image_pyramid.h"
+#include "core/hash.h"
+#include "core/job_system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <system_error>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CT_PYRAMID_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace ct {
+
+namespace {
+
+constexpr char kSidecarMagic[8] = {'C', 'T', 'P', 'Y', 'R', '0', '1', '\0'};
+constexpr uint32_t kSidecarVersion = 1;
+constexpr uint64_t kSidecarDataOffset = 4096;  // Tile data starts page aligned
+constexpr size_t kFingerprintSampleBytes = 1 << 20;
+
+/// Fixed-size header at the start of every sidecar
+struct SidecarHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t tileSize;
+    uint32_t width;
+    uint32_t height;
+    uint32_t channelCount;
+    uint32_t levelCount;
+    uint64_t fileSize;
+    int64_t modifiedTime;
+    uint64_t sampleHash;
+};
+
+/// Fill the part of a region beyond validWidth/validHeight by repeating the last column and row
+void padRegion(uint16_t* pixels, size_t stride, uint32_t validWidth, uint32_t validHeight,
+               uint32_t width, uint32_t height) {
+    for (uint32_t y = 0; y < validHeight; y++) {
+        uint16_t* row = pixels + y * stride;
+        std::fill(row + validWidth, row + width, row[validWidth - 1]);
+    }
+    for (uint32_t y = validHeight; y < height; y++) {
+        std::memcpy(pixels + y * stride, pixels + (validHeight - 1) * stride, width * sizeof(uint16_t));
+    }
+}
+
+} // namespace
+
+ImagePyramid::~ImagePyramid() {
+    close();
+}
+
+bool ImagePyramid::open(const ImageSource& source, const ImagePyramidConfig& config) {
+    close();
+
+    if (config.tileSize < 8 || (config.tileSize & (config.tileSize - 1)) != 0) {
+        std::cerr << "Pyramid tile size must be a power of two >= 8, got " << config.tileSize << "\n";
+        return false;
+    }
+
+    if (source.getWidth() == 0 || source.getHeight() == 0 || source.getChannelCount() == 0) {
+        std::cerr << "Cannot build a pyramid for an empty image: " << source.getPath() << "\n";
+        return false;
+    }
+
+    m_source = &source;
+    m_tileSize = config.tileSize;
+    m_sidecarPath = config.sidecarPath;
+    if (m_sidecarPath.empty()) {
+        m_sidecarPath = source.getPath();
+        m_sidecarPath += ".ctpyr";
+    }
+
+    computeLevels();
+
+    SourceFingerprint fingerprint;
+    if (!computeFingerprint(source.getPath(), fingerprint)) {
+        std::cerr << "Failed to fingerprint pyramid source: " << source.getPath() << "\n";
+        m_source = nullptr;
+        return false;
+    }
+
+    if (loadSidecar(fingerprint)) {
+        std::cout << "Pyramid cache hit: " << m_sidecarPath << " (" << m_levels.size() << " levels)\n";
+        return true;
+    }
+
+    if (!buildSidecar(fingerprint, config.threadCount)) {
+        close();
+        return false;
+    }
+
+    m_rebuilt = true;
+    return true;
+}
+
+void ImagePyramid::close() {
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+    m_source = nullptr;
+    m_levels.clear();
+    m_levelOffsets.clear();
+    m_rebuilt = false;
+}
+
+bool ImagePyramid::readTile(uint32_t level, uint32_t channel, uint32_t tileX, uint32_t tileY,
+                            uint16_t* destination) const {
+    if (level >= m_levels.size() || channel >= m_source->getChannelCount()
+        || tileX >= m_levels[level].tilesX || tileY >= m_levels[level].tilesY) {
+        return false;
+    }
+
+    if (level == 0) {
+        return readSourceTile(channel, tileX, tileY, destination);
+    }
+
+    return readSidecarTile(m_file, getTileOffset(level, channel, tileX, tileY), destination);
+}
+
+bool ImagePyramid::computeFingerprint(const std::filesystem::path& path, SourceFingerprint& fingerprint) {
+    std::error_code ec;
+    fingerprint.fileSize = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+    fingerprint.modifiedTime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+    if (ec) {
+        return false;
+    }
+
+    // Head and tail samples catch in-place rewrites that preserve size and mtime
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    std::vector<char> sample(static_cast<size_t>(std::min<uint64_t>(fingerprint.fileSize, kFingerprintSampleBytes)));
+    Hasher64 hasher;
+    hasher.updateValue(fingerprint.fileSize);
+
+    file.read(sample.data(), static_cast<std::streamsize>(sample.size()));
+    hasher.update(sample.data(), static_cast<size_t>(file.gcount()));
+
+    if (fingerprint.fileSize > sample.size()) {
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(fingerprint.fileSize - sample.size()));
+        file.read(sample.data(), static_cast<std::streamsize>(sample.size()));
+        hasher.update(sample.data(), static_cast<size_t>(file.gcount()));
+    }
+
+    fingerprint.sampleHash = hasher.digest();
+    return true;
+}
+
+void ImagePyramid::downsample2x2(const uint16_t* source, size_t sourceStride,
+                                 uint16_t* destination, size_t destinationStride,
+                                 uint32_t width, uint32_t height) {
+    for (uint32_t y = 0; y < height; y++) {
+        const uint16_t* row0 = source + (2 * y) * sourceStride;
+        const uint16_t* row1 = row0 + sourceStride;
+        uint16_t* out = destination + y * destinationStride;
+        uint32_t x = 0;
+
+#if CT_PYRAMID_SSE2
+        // Bias to signed so _mm_madd_epi16 can sum horizontal pairs without overflow,
+        // then undo the bias (4 * 32768) together with the +2 rounding term
+        const __m128i signBit = _mm_set1_epi16(-32768);
+        const __m128i ones = _mm_set1_epi16(1);
+        const __m128i unbias = _mm_set1_epi32(4 * 32768 + 2);
+        const __m128i rebias = _mm_set1_epi32(32768);
+
+        for (; x + 8 <= width; x += 8) {
+            const __m128i a0 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 2 * x)), signBit);
+            const __m128i a1 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 2 * x + 8)), signBit);
+            const __m128i b0 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 2 * x)), signBit);
+            const __m128i b1 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 2 * x + 8)), signBit);
+
+            __m128i sumLo = _mm_add_epi32(_mm_madd_epi16(a0, ones), _mm_madd_epi16(b0, ones));
+            __m128i sumHi = _mm_add_epi32(_mm_madd_epi16(a1, ones), _mm_madd_epi16(b1, ones));
+            sumLo = _mm_sub_epi32(_mm_srai_epi32(_mm_add_epi32(sumLo, unbias), 2), rebias);
+            sumHi = _mm_sub_epi32(_mm_srai_epi32(_mm_add_epi32(sumHi, unbias), 2), rebias);
+
+            const __m128i packed = _mm_xor_si128(_mm_packs_epi32(sumLo, sumHi), signBit);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), packed);
+        }
+#endif
+
+        for (; x < width; x++) {
+            const uint32_t sum = static_cast<uint32_t>(row0[2 * x]) + row0[2 * x + 1] + row1[2 * x] + row1[2 * x + 1];
+            out[x] = static_cast<uint16_t>((sum + 2) >> 2);
+        }
+    }
+}
+
+void ImagePyramid::computeLevels() {
+    m_levels.clear();
+    m_levelOffsets.clear();
+
+    uint32_t width = m_source->getWidth();
+    uint32_t height = m_source->getHeight();
+    uint64_t offset = kSidecarDataOffset;
+    const uint64_t tileBytes = static_cast<uint64_t>(m_tileSize) * m_tileSize * sizeof(uint16_t);
+
+    for (;;) {
+        PyramidLevel level;
+        level.width = width;
+        level.height = height;
+        level.tilesX = (width + m_tileSize - 1) / m_tileSize;
+        level.tilesY = (height + m_tileSize - 1) / m_tileSize;
+
+        // Level 0 lives in the source, not the sidecar
+        m_levelOffsets.push_back(m_levels.empty() ? 0 : offset);
+        if (!m_levels.empty()) {
+            offset += tileBytes * level.tilesX * level.tilesY * m_source->getChannelCount();
+        }
+        m_levels.push_back(level);
+
+        if (width <= m_tileSize && height <= m_tileSize) {
+            break;
+        }
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+    }
+}
+
+bool ImagePyramid::loadSidecar(const SourceFingerprint& fingerprint) {
+    std::fstream file(m_sidecarPath, std::ios::in | std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    SidecarHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, kSidecarMagic, sizeof(kSidecarMagic)) != 0
+        || header.version != kSidecarVersion) {
+        return false;
+    }
+
+    const SourceFingerprint stored{header.fileSize, header.modifiedTime, header.sampleHash};
+    if (stored != fingerprint
+        || header.tileSize != m_tileSize
+        || header.width != m_source->getWidth()
+        || header.height != m_source->getHeight()
+        || header.channelCount != m_source->getChannelCount()
+        || header.levelCount != m_levels.size()) {
+        std::cout << "Pyramid cache is stale, rebuilding: " << m_sidecarPath << "\n";
+        return false;
+    }
+
+    m_file = std::move(file);
+    return true;
+}
+
+bool ImagePyramid::buildSidecar(const SourceFingerprint& fingerprint, uint32_t threadCount) {
+    const auto startTime = std::chrono::steady_clock::now();
+
+    // Build into a temporary file so an interrupted build never looks valid
+    auto tempPath = m_sidecarPath;
+    tempPath += ".tmp";
+
+    std::fstream file(tempPath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Failed to create pyramid sidecar: " << tempPath << "\n";
+        return false;
+    }
+
+    std::cout << "Building pyramid for " << m_source->getPath() << ": " << m_levels.size() - 1
+              << " level(s), " << m_source->getChannelCount() << " channel(s)\n";
+
+    JobSystem jobs;
+    jobs.initialize(threadCount);
+
+    const uint32_t tileSize = m_tileSize;
+    const uint32_t channelCount = m_source->getChannelCount();
+    std::atomic<bool> failed{false};
+
+    for (uint32_t level = 1; level < m_levels.size() && !failed; level++) {
+        const PyramidLevel& current = m_levels[level];
+        const PyramidLevel& previous = m_levels[level - 1];
+        const size_t tileCount = static_cast<size_t>(current.tilesX) * current.tilesY * channelCount;
+
+        jobs.parallelFor(tileCount, 4, [&](size_t begin, size_t end) {
+            // Per-batch scratch: one 2x2 block of input tiles and one output tile
+            const size_t inputStride = 2 * static_cast<size_t>(tileSize);
+            std::vector<uint16_t> input(inputStride * inputStride);
+            std::vector<uint16_t> output(static_cast<size_t>(tileSize) * tileSize);
+            std::vector<uint16_t> tile(static_cast<size_t>(tileSize) * tileSize);
+
+            for (size_t i = begin; i < end && !failed; i++) {
+                const auto tileX = static_cast<uint32_t>(i % current.tilesX);
+                const auto tileY = static_cast<uint32_t>((i / current.tilesX) % current.tilesY);
+                const auto channel = static_cast<uint32_t>(i / (static_cast<size_t>(current.tilesX) * current.tilesY));
+
+                const uint32_t x0 = tileX * 2 * tileSize;
+                const uint32_t y0 = tileY * 2 * tileSize;
+                const uint32_t validWidth = std::min(2 * tileSize, previous.width - x0);
+                const uint32_t validHeight = std::min(2 * tileSize, previous.height - y0);
+
+                bool ok = true;
+                if (level == 1) {
+                    ok = m_source->readRegion(channel, x0, y0, validWidth, validHeight, input.data(), inputStride);
+                } else {
+                    for (uint32_t dy = 0; dy < 2 && ok; dy++) {
+                        for (uint32_t dx = 0; dx < 2 && ok; dx++) {
+                            const uint32_t sourceTileX = tileX * 2 + dx;
+                            const uint32_t sourceTileY = tileY * 2 + dy;
+                            if (sourceTileX >= previous.tilesX || sourceTileY >= previous.tilesY) {
+                                continue;
+                            }
+
+                            ok = readSidecarTile(file, getTileOffset(level - 1, channel, sourceTileX, sourceTileY),
+                                                 tile.data());
+                            for (uint32_t row = 0; row < tileSize && ok; row++) {
+                                std::memcpy(input.data() + (dy * tileSize + row) * inputStride + dx * tileSize,
+                                            tile.data() + static_cast<size_t>(row) * tileSize,
+                                            tileSize * sizeof(uint16_t));
+                            }
+                        }
+                    }
+                }
+
+                if (!ok) {
+                    failed = true;
+                    break;
+                }
+
+                padRegion(input.data(), inputStride, validWidth, validHeight, 2 * tileSize, 2 * tileSize);
+                downsample2x2(input.data(), inputStride, output.data(), tileSize, tileSize, tileSize);
+
+                if (!writeSidecarTile(file, getTileOffset(level, channel, tileX, tileY), output.data())) {
+                    failed = true;
+                }
+            }
+        });
+
+        std::cout << "  Level " << level << ": " << current.width << "x" << current.height
+                  << " (" << tileCount << " tiles)\n";
+    }
+
+    jobs.shutdown();
+
+    if (failed) {
+        std::cerr << "Failed to build pyramid for " << m_source->getPath() << "\n";
+        file.close();
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    // Header goes last: it marks the sidecar complete
+    SidecarHeader header{};
+    std::memcpy(header.magic, kSidecarMagic, sizeof(kSidecarMagic));
+    header.version = kSidecarVersion;
+    header.tileSize = m_tileSize;
+    header.width = m_source->getWidth();
+    header.height = m_source->getHeight();
+    header.channelCount = channelCount;
+    header.levelCount = static_cast<uint32_t>(m_levels.size());
+    header.fileSize = fingerprint.fileSize;
+    header.modifiedTime = fingerprint.modifiedTime;
+    header.sampleHash = fingerprint.sampleHash;
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, m_sidecarPath, ec);
+    if (ec) {
+        std::cerr << "Failed to move pyramid sidecar into place: " << m_sidecarPath << " (" << ec.message() << ")\n";
+        return false;
+    }
+
+    m_file.open(m_sidecarPath, std::ios::in | std::ios::binary);
+    if (!m_file) {
+        std::cerr << "Failed to reopen pyramid sidecar: " << m_sidecarPath << "\n";
+        return false;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Pyramid built in " << seconds << "s: " << m_sidecarPath << "\n";
+    return true;
+}
+
+uint64_t ImagePyramid::getTileOffset(uint32_t level, uint32_t channel, uint32_t tileX, uint32_t tileY) const {
+    const PyramidLevel& info = m_levels[level];
+    const uint64_t tileBytes = static_cast<uint64_t>(m_tileSize) * m_tileSize * sizeof(uint16_t);
+    const uint64_t tileIndex = (static_cast<uint64_t>(channel) * info.tilesY + tileY) * info.tilesX + tileX;
+    return m_levelOffsets[level] + tileIndex * tileBytes;
+}
+
+bool ImagePyramid::readSourceTile(uint32_t channel, uint32_t tileX, uint32_t tileY, uint16_t* destination) const {
+    const PyramidLevel& level = m_levels[0];
+    const uint32_t x0 = tileX * m_tileSize;
+    const uint32_t y0 = tileY * m_tileSize;
+    const uint32_t validWidth = std::min(m_tileSize, level.width - x0);
+    const uint32_t validHeight = std::min(m_tileSize, level.height - y0);
+
+    if (!m_source->readRegion(channel, x0, y0, validWidth, validHeight, destination, m_tileSize)) {
+        return false;
+    }
+
+    padRegion(destination, m_tileSize, validWidth, validHeight, m_tileSize, m_tileSize);
+    return true;
+}
+
+bool ImagePyramid::readSidecarTile(std::fstream& file, uint64_t offset, uint16_t* destination) const {
+    const auto tileBytes = static_cast<std::streamsize>(static_cast<size_t>(m_tileSize) * m_tileSize * sizeof(uint16_t));
+
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(reinterpret_cast<char*>(destination), tileBytes);
+    if (!file) {
+        file.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ImagePyramid::writeSidecarTile(std::fstream& file, uint64_t offset, const uint16_t* source) const {
+    const auto tileBytes = static_cast<std::streamsize>(static_cast<size_t>(m_tileSize) * m_tileSize * sizeof(uint16_t));
+
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(reinterpret_cast<const char*>(source), tileBytes);
+    if (!file) {
+        file.clear();
+        return false;
+    }
+    return true;
+}
+
+} // namespace ct
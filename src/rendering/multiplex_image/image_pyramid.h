@@ -0,0 +1,121 @@
+#pragma once
+
+#include "rendering/multiplex_image/image_source.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ct {
+
+/// Configuration for pyramid building and caching
+struct ImagePyramidConfig {
+    uint32_t tileSize = 256;                // Tile edge in pixels (power of two)
+    uint32_t threadCount = 0;               // Build workers (0 = all hardware threads)
+    std::filesystem::path sidecarPath;      // Defaults to <source>.ctpyr
+};
+
+/// Dimensions of one pyramid level
+struct PyramidLevel {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t tilesX = 0;
+    uint32_t tilesY = 0;
+};
+
+/// Identifies the exact source file a sidecar was built from
+struct SourceFingerprint {
+    uint64_t fileSize = 0;
+    int64_t modifiedTime = 0;
+    uint64_t sampleHash = 0;    // Hash of the first and last MiB
+
+    bool operator==(const SourceFingerprint&) const = default;
+};
+
+/// Tiled mipmap pyramid for a multiplex image, persisted in a sidecar file
+///
+/// Level 0 is the source itself; levels 1..N are 2x2 area averages built in parallel,
+/// one tile at a time, so memory stays bounded regardless of image size. The sidecar
+/// is reused as long as the source fingerprint matches.
+class ImagePyramid {
+public:
+    ImagePyramid() = default;
+    ~ImagePyramid();
+
+    // Non-copyable
+    ImagePyramid(const ImagePyramid&) = delete;
+    ImagePyramid& operator=(const ImagePyramid&) = delete;
+
+    /// Open the pyramid for a source, building the sidecar if it is missing or stale
+    /// @param source Full-resolution image (must outlive the pyramid)
+    /// @param config Pyramid configuration settings
+    /// @return true if the pyramid is ready for reading
+    bool open(const ImageSource& source, const ImagePyramidConfig& config = {});
+
+    /// Close the sidecar file
+    void close();
+
+    /// Get the number of levels, including the full-resolution level 0
+    [[nodiscard]] uint32_t getLevelCount() const { return static_cast<uint32_t>(m_levels.size()); }
+
+    /// Get the dimensions of a level
+    [[nodiscard]] const PyramidLevel& getLevel(uint32_t level) const { return m_levels[level]; }
+
+    /// Get the tile edge length in pixels
+    [[nodiscard]] uint32_t getTileSize() const { return m_tileSize; }
+
+    /// Check whether open() had to build the sidecar
+    [[nodiscard]] bool wasRebuilt() const { return m_rebuilt; }
+
+    /// Read one tile; edge tiles are padded by repeating the last row/column
+    /// @param destination Receives tileSize * tileSize pixels
+    /// @return true if the tile was read
+    bool readTile(uint32_t level, uint32_t channel, uint32_t tileX, uint32_t tileY, uint16_t* destination) const;
+
+    /// Compute a source fingerprint (size, mtime and a sampled content hash)
+    static bool computeFingerprint(const std::filesystem::path& path, SourceFingerprint& fingerprint);
+
+    /// 2x2 area-average downsample of uint16 pixels (SSE2 when available)
+    /// @param source Input pixels, 2 * width by 2 * height
+    /// @param sourceStride Input row stride in pixels
+    /// @param destination Output pixels, width by height
+    /// @param destinationStride Output row stride in pixels
+    static void downsample2x2(const uint16_t* source, size_t sourceStride,
+                              uint16_t* destination, size_t destinationStride,
+                              uint32_t width, uint32_t height);
+
+private:
+    /// Compute level dimensions for the current source and tile size
+    void computeLevels();
+
+    /// Validate an existing sidecar against the source
+    bool loadSidecar(const SourceFingerprint& fingerprint);
+
+    /// Build the sidecar from the source
+    bool buildSidecar(const SourceFingerprint& fingerprint, uint32_t threadCount);
+
+    /// Byte offset of a tile within the sidecar (levels >= 1)
+    [[nodiscard]] uint64_t getTileOffset(uint32_t level, uint32_t channel, uint32_t tileX, uint32_t tileY) const;
+
+    /// Read a level 0 tile directly from the source
+    bool readSourceTile(uint32_t channel, uint32_t tileX, uint32_t tileY, uint16_t* destination) const;
+
+    /// Read or write a sidecar tile under the file lock
+    bool readSidecarTile(std::fstream& file, uint64_t offset, uint16_t* destination) const;
+    bool writeSidecarTile(std::fstream& file, uint64_t offset, const uint16_t* source) const;
+
+    const ImageSource* m_source = nullptr;
+    std::filesystem::path m_sidecarPath;
+    mutable std::fstream m_file;
+    mutable std::mutex m_fileMutex;
+    std::vector<PyramidLevel> m_levels;
+    std::vector<uint64_t> m_levelOffsets;   // Sidecar offset of each level's first tile (0 for level 0)
+    uint32_t m_tileSize = 0;
+    bool m_rebuilt = false;
+};
+
+} // namespace ct
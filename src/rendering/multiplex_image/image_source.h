@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace ct {
+
+/// Read access to a multi-channel uint16 image at full resolution
+/// Implemented by the multiplex loaders; all methods must be safe to call concurrently
+class ImageSource {
+public:
+    virtual ~ImageSource() = default;
+
+    /// Get the image dimensions in pixels
+    [[nodiscard]] virtual uint32_t getWidth() const = 0;
+    [[nodiscard]] virtual uint32_t getHeight() const = 0;
+
+    /// Get the number of channels (markers)
+    [[nodiscard]] virtual uint32_t getChannelCount() const = 0;
+
+    /// Get the file backing this image (used to validate derived caches)
+    [[nodiscard]] virtual std::filesystem::path getPath() const = 0;
+
+    /// Read a rectangle of one channel
+    /// @param channel Channel index
+    /// @param x Left edge in pixels
+    /// @param y Top edge in pixels
+    /// @param width Rectangle width (x + width must not exceed the image width)
+    /// @param height Rectangle height (y + height must not exceed the image height)
+    /// @param destination Output pixels
+    /// @param rowStride Distance between output rows, in pixels
+    /// @return true if the region was read
+    virtual bool readRegion(uint32_t channel, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                            uint16_t* destination, size_t rowStride) const = 0;
+};
+
+} // namespace ct
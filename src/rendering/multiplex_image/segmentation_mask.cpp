@@ -0,0 +1,594 @@
+#include "rendering/multiplex_image/segmentation_mask.h"
+#include "core/job_system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <unordered_map>
+
+namespace ct {
+
+namespace {
+
+constexpr char kMaskMagic[8] = {'C', 'T', 'M', 'S', 'K', '0', '1', '\0'};
+constexpr uint32_t kMaskVersion = 1;
+
+/// Fixed-size header at the start of every mask file
+struct MaskFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t tileSize;
+    uint32_t width;
+    uint32_t height;
+    uint64_t cellCount;
+};
+
+/// Running bounds and coordinate sums for one label within one tile
+struct CellAccumulator {
+    uint32_t minX = UINT32_MAX;
+    uint32_t minY = UINT32_MAX;
+    uint32_t maxX = 0;
+    uint32_t maxY = 0;
+    uint64_t area = 0;
+    uint64_t sumX = 0;
+    uint64_t sumY = 0;
+
+    void addRun(uint32_t x0, uint32_t x1, uint32_t y) {
+        const uint64_t length = x1 - x0;
+        minX = std::min(minX, x0);
+        maxX = std::max(maxX, x1 - 1);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        area += length;
+        sumX += (static_cast<uint64_t>(x0) + x1 - 1) * length / 2;
+        sumY += static_cast<uint64_t>(y) * length;
+    }
+
+    void merge(const CellAccumulator& other) {
+        minX = std::min(minX, other.minX);
+        minY = std::min(minY, other.minY);
+        maxX = std::max(maxX, other.maxX);
+        maxY = std::max(maxY, other.maxY);
+        area += other.area;
+        sumX += other.sumX;
+        sumY += other.sumY;
+    }
+};
+
+template <typename T>
+void writeVector(std::ofstream& file, const std::vector<T>& values) {
+    const uint64_t count = values.size();
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+template <typename T>
+bool readVector(std::ifstream& file, std::vector<T>& values, uint64_t maxCount) {
+    uint64_t count = 0;
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!file || count > maxCount) {
+        return false;
+    }
+    values.resize(count);
+    file.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T)));
+    return static_cast<bool>(file);
+}
+
+/// Even-odd point in polygon test
+bool pointInPolygon(const std::vector<glm::vec2>& polygon, glm::vec2 point) {
+    bool inside = false;
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        const glm::vec2 a = polygon[i];
+        const glm::vec2 b = polygon[j];
+        if ((a.y > point.y) != (b.y > point.y)
+            && point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+} // namespace
+
+bool SegmentationMask::build(const LabelSource& source, uint32_t threadCount) {
+    const auto start = std::chrono::steady_clock::now();
+
+    m_width = source.getWidth();
+    m_height = source.getHeight();
+    if (m_width == 0 || m_height == 0) {
+        std::cerr << "Failed to build segmentation mask: empty label image\n";
+        return false;
+    }
+
+    m_tilesX = (m_width + kTileSize - 1) / kTileSize;
+    m_tilesY = (m_height + kTileSize - 1) / kTileSize;
+    const size_t tileCount = static_cast<size_t>(m_tilesX) * m_tilesY;
+    m_tiles.assign(tileCount, {});
+    m_cells.clear();
+
+    // Per-tile accumulators, indexed like the tile palette
+    std::vector<std::vector<CellAccumulator>> partials(tileCount);
+    std::atomic<bool> failed{false};
+
+    JobSystem jobs;
+    jobs.initialize(threadCount);
+    jobs.parallelFor(tileCount, 1, [&](size_t begin, size_t end) {
+        std::vector<uint32_t> pixels(static_cast<size_t>(kTileSize) * kTileSize);
+        std::unordered_map<uint32_t, uint16_t> paletteLookup;
+        for (size_t index = begin; index < end && !failed; index++) {
+            const auto tileX = static_cast<uint32_t>(index % m_tilesX);
+            const auto tileY = static_cast<uint32_t>(index / m_tilesX);
+            const uint32_t x0 = tileX * kTileSize;
+            const uint32_t y0 = tileY * kTileSize;
+            const uint32_t width = std::min(kTileSize, m_width - x0);
+            const uint32_t height = std::min(kTileSize, m_height - y0);
+
+            if (!source.readRegion(x0, y0, width, height, pixels.data(), kTileSize)) {
+                failed = true;
+                return;
+            }
+
+            MaskTile& tile = m_tiles[index];
+            std::vector<CellAccumulator>& cells = partials[index];
+            tile.rowOffsets.reserve(kTileSize + 1);
+            tile.rowOffsets.push_back(0);
+
+            // Labels repeat heavily between rows, so remember the last palette hit
+            paletteLookup.clear();
+            uint32_t lastLabel = UINT32_MAX;
+            uint16_t lastIndex = 0;
+            const auto paletteIndex = [&](uint32_t label) {
+                if (label != lastLabel) {
+                    auto [it, inserted] = paletteLookup.try_emplace(label, static_cast<uint16_t>(tile.palette.size()));
+                    if (inserted) {
+                        tile.palette.push_back(label);
+                        cells.emplace_back();
+                    }
+                    lastLabel = label;
+                    lastIndex = it->second;
+                }
+                return lastIndex;
+            };
+
+            for (uint32_t y = 0; y < kTileSize; y++) {
+                if (y < height) {
+                    const uint32_t* row = pixels.data() + static_cast<size_t>(y) * kTileSize;
+                    uint32_t x = 0;
+                    while (x < width) {
+                        const uint32_t label = row[x];
+                        uint32_t runEnd = x + 1;
+                        while (runEnd < width && row[runEnd] == label) {
+                            runEnd++;
+                        }
+
+                        const uint16_t entry = paletteIndex(label);
+                        tile.runStarts.push_back(static_cast<uint8_t>(x));
+                        tile.runLabels.push_back(entry);
+                        if (label != 0) {
+                            cells[entry].addRun(x0 + x, x0 + runEnd, y0 + y);
+                        }
+                        x = runEnd;
+                    }
+                }
+                tile.rowOffsets.push_back(static_cast<uint32_t>(tile.runStarts.size()));
+            }
+
+            tile.runStarts.shrink_to_fit();
+            tile.runLabels.shrink_to_fit();
+        }
+    });
+    jobs.shutdown();
+
+    if (failed) {
+        std::cerr << "Failed to read label mask\n";
+        m_tiles.clear();
+        return false;
+    }
+
+    // Merge tile partials; cells spanning tile borders appear in several
+    std::vector<std::pair<uint32_t, const CellAccumulator*>> entries;
+    for (size_t index = 0; index < tileCount; index++) {
+        const MaskTile& tile = m_tiles[index];
+        for (size_t i = 0; i < tile.palette.size(); i++) {
+            if (tile.palette[i] != 0) {
+                entries.emplace_back(tile.palette[i], &partials[index][i]);
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (size_t i = 0; i < entries.size();) {
+        CellAccumulator total = *entries[i].second;
+        size_t next = i + 1;
+        while (next < entries.size() && entries[next].first == entries[i].first) {
+            total.merge(*entries[next].second);
+            next++;
+        }
+
+        CellInfo cell;
+        cell.label = entries[i].first;
+        cell.minX = total.minX;
+        cell.minY = total.minY;
+        cell.maxX = total.maxX;
+        cell.maxY = total.maxY;
+        cell.area = total.area;
+        const auto area = static_cast<double>(total.area);
+        cell.centroid = glm::vec2(static_cast<float>(static_cast<double>(total.sumX) / area + 0.5),
+                                  static_cast<float>(static_cast<double>(total.sumY) / area + 0.5));
+        m_cells.push_back(cell);
+        i = next;
+    }
+
+    buildSpatialIndex();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double rawBytes = static_cast<double>(m_width) * m_height * sizeof(uint32_t);
+    std::cout << "Segmentation mask built: " << m_width << "x" << m_height << ", " << m_cells.size()
+              << " cells, " << getEncodedBytes() / (1024 * 1024) << " MiB encoded ("
+              << static_cast<double>(getEncodedBytes()) / rawBytes * 100.0 << "% of raw) in "
+              << seconds << " s\n";
+    return true;
+}
+
+bool SegmentationMask::save(const std::filesystem::path& path) const {
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Failed to create mask file: " << tempPath << "\n";
+        return false;
+    }
+
+    MaskFileHeader header{};
+    std::memcpy(header.magic, kMaskMagic, sizeof(kMaskMagic));
+    header.version = kMaskVersion;
+    header.tileSize = kTileSize;
+    header.width = m_width;
+    header.height = m_height;
+    header.cellCount = m_cells.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const MaskTile& tile : m_tiles) {
+        writeVector(file, tile.palette);
+        writeVector(file, tile.rowOffsets);
+        writeVector(file, tile.runStarts);
+        writeVector(file, tile.runLabels);
+    }
+    file.write(reinterpret_cast<const char*>(m_cells.data()),
+               static_cast<std::streamsize>(m_cells.size() * sizeof(CellInfo)));
+    file.close();
+
+    if (!file) {
+        std::cerr << "Failed to write mask file: " << tempPath << "\n";
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::cerr << "Failed to move mask file into place: " << path << " (" << ec.message() << ")\n";
+        return false;
+    }
+    return true;
+}
+
+bool SegmentationMask::load(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open mask file: " << path << "\n";
+        return false;
+    }
+
+    MaskFileHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, kMaskMagic, sizeof(kMaskMagic)) != 0
+        || header.version != kMaskVersion || header.tileSize != kTileSize
+        || header.width == 0 || header.height == 0) {
+        std::cerr << "Failed to load mask file (bad header): " << path << "\n";
+        return false;
+    }
+
+    m_width = header.width;
+    m_height = header.height;
+    m_tilesX = (m_width + kTileSize - 1) / kTileSize;
+    m_tilesY = (m_height + kTileSize - 1) / kTileSize;
+    m_tiles.assign(static_cast<size_t>(m_tilesX) * m_tilesY, {});
+
+    constexpr uint64_t maxRuns = static_cast<uint64_t>(kTileSize) * kTileSize;
+    for (size_t index = 0; index < m_tiles.size(); index++) {
+        MaskTile& tile = m_tiles[index];
+        const uint32_t y0 = static_cast<uint32_t>(index / m_tilesX) * kTileSize;
+        if (!readVector(file, tile.palette, maxRuns)
+            || !readVector(file, tile.rowOffsets, kTileSize + 1)
+            || !readVector(file, tile.runStarts, maxRuns)
+            || !readVector(file, tile.runLabels, maxRuns)
+            || !isTileValid(tile, std::min(kTileSize, m_height - y0))) {
+            std::cerr << "Failed to load mask file (corrupt tile): " << path << "\n";
+            m_tiles.clear();
+            return false;
+        }
+    }
+
+    // Every cell covers at least one pixel
+    if (header.cellCount > static_cast<uint64_t>(m_width) * m_height) {
+        std::cerr << "Failed to load mask file (bad cell count): " << path << "\n";
+        m_tiles.clear();
+        return false;
+    }
+
+    m_cells.resize(header.cellCount);
+    file.read(reinterpret_cast<char*>(m_cells.data()),
+              static_cast<std::streamsize>(m_cells.size() * sizeof(CellInfo)));
+    if (!file) {
+        std::cerr << "Failed to load mask file (truncated cell table): " << path << "\n";
+        m_tiles.clear();
+        m_cells.clear();
+        return false;
+    }
+
+    if (!isCellTableValid()) {
+        std::cerr << "Failed to load mask file (corrupt cell table): " << path << "\n";
+        m_tiles.clear();
+        m_cells.clear();
+        return false;
+    }
+
+    buildSpatialIndex();
+    return true;
+}
+
+uint32_t SegmentationMask::pickCell(uint32_t x, uint32_t y) const {
+    if (x >= m_width || y >= m_height) {
+        return 0;
+    }
+
+    const MaskTile& tile = m_tiles[static_cast<size_t>(y / kTileSize) * m_tilesX + x / kTileSize];
+    const uint32_t row = y % kTileSize;
+    const auto first = tile.runStarts.begin() + tile.rowOffsets[row];
+    const auto last = tile.runStarts.begin() + tile.rowOffsets[row + 1];
+
+    // Last run starting at or before the column
+    const auto column = static_cast<uint8_t>(x % kTileSize);
+    const auto run = std::upper_bound(first, last, column) - 1;
+    return tile.palette[tile.runLabels[static_cast<size_t>(run - tile.runStarts.begin())]];
+}
+
+void SegmentationMask::queryPolygon(const std::vector<glm::vec2>& polygon, std::vector<uint32_t>& labels) const {
+    if (polygon.size() < 3 || m_cells.empty()) {
+        return;
+    }
+
+    glm::vec2 low = polygon[0];
+    glm::vec2 high = polygon[0];
+    for (const glm::vec2& point : polygon) {
+        low = glm::min(low, point);
+        high = glm::max(high, point);
+    }
+    if (high.x < 0.0f || high.y < 0.0f) {
+        return;
+    }
+
+    const auto clampCoordinate = [](float value, uint32_t limit) {
+        return static_cast<uint32_t>(std::clamp(value, 0.0f, static_cast<float>(limit - 1)));
+    };
+
+    std::vector<uint32_t> candidates;
+    gatherCandidates(clampCoordinate(low.x, m_width), clampCoordinate(low.y, m_height),
+                     clampCoordinate(high.x, m_width), clampCoordinate(high.y, m_height), candidates);
+
+    for (uint32_t index : candidates) {
+        const CellInfo& cell = m_cells[index];
+        if (pointInPolygon(polygon, cell.centroid)) {
+            labels.push_back(cell.label);
+        }
+    }
+}
+
+void SegmentationMask::queryRect(uint32_t minX, uint32_t minY, uint32_t maxX, uint32_t maxY,
+                                 std::vector<uint32_t>& labels) const {
+    if (m_cells.empty() || minX > maxX || minY > maxY || minX >= m_width || minY >= m_height) {
+        return;
+    }
+
+    std::vector<uint32_t> candidates;
+    gatherCandidates(minX, minY, std::min(maxX, m_width - 1), std::min(maxY, m_height - 1), candidates);
+
+    for (uint32_t index : candidates) {
+        const CellInfo& cell = m_cells[index];
+        if (cell.minX <= maxX && cell.maxX >= minX && cell.minY <= maxY && cell.maxY >= minY) {
+            labels.push_back(cell.label);
+        }
+    }
+}
+
+const CellInfo* SegmentationMask::findCell(uint32_t label) const {
+    auto it = std::lower_bound(m_cells.begin(), m_cells.end(), label,
+                               [](const CellInfo& cell, uint32_t value) { return cell.label < value; });
+    return it != m_cells.end() && it->label == label ? &*it : nullptr;
+}
+
+void SegmentationMask::decodeTile(uint32_t tileX, uint32_t tileY, uint32_t* destination) const {
+    const MaskTile& tile = m_tiles[static_cast<size_t>(tileY) * m_tilesX + tileX];
+
+    for (uint32_t y = 0; y < kTileSize; y++) {
+        uint32_t* row = destination + static_cast<size_t>(y) * kTileSize;
+        const uint32_t first = tile.rowOffsets[y];
+        const uint32_t last = tile.rowOffsets[y + 1];
+        if (first == last) {
+            std::fill(row, row + kTileSize, 0u);
+            continue;
+        }
+
+        for (uint32_t run = first; run < last; run++) {
+            const uint32_t begin = tile.runStarts[run];
+            const uint32_t end = run + 1 < last ? tile.runStarts[run + 1] : kTileSize;
+            std::fill(row + begin, row + end, tile.palette[tile.runLabels[run]]);
+        }
+    }
+
+    // Columns past the right image edge belong to no run
+    const uint32_t validWidth = std::min(kTileSize, m_width - tileX * kTileSize);
+    if (validWidth < kTileSize) {
+        for (uint32_t y = 0; y < kTileSize; y++) {
+            uint32_t* row = destination + static_cast<size_t>(y) * kTileSize;
+            std::fill(row + validWidth, row + kTileSize, 0u);
+        }
+    }
+}
+
+void SegmentationMask::getTileRuns(uint32_t tileX, uint32_t tileY, std::vector<LabelRun>& runs) const {
+    const MaskTile& tile = m_tiles[static_cast<size_t>(tileY) * m_tilesX + tileX];
+    const uint32_t validWidth = std::min(kTileSize, m_width - tileX * kTileSize);
+
+    for (uint32_t y = 0; y < kTileSize; y++) {
+        const uint32_t last = tile.rowOffsets[y + 1];
+        for (uint32_t run = tile.rowOffsets[y]; run < last; run++) {
+            const uint32_t label = tile.palette[tile.runLabels[run]];
+            if (label == 0) {
+                continue;
+            }
+            const uint32_t begin = tile.runStarts[run];
+            const uint32_t end = run + 1 < last ? tile.runStarts[run + 1] : validWidth;
+            runs.push_back({label, static_cast<uint16_t>(y), static_cast<uint16_t>(begin),
+                            static_cast<uint16_t>(end - begin)});
+        }
+    }
+}
+
+void SegmentationMask::buildSelectionBits(const std::vector<uint32_t>& labels, uint32_t maxLabel,
+                                          std::vector<uint32_t>& bits) {
+    bits.assign(maxLabel / 32 + 1, 0u);
+    for (uint32_t label : labels) {
+        if (label <= maxLabel) {
+            bits[label / 32] |= 1u << (label % 32);
+        }
+    }
+}
+
+size_t SegmentationMask::getEncodedBytes() const {
+    size_t bytes = 0;
+    for (const MaskTile& tile : m_tiles) {
+        bytes += tile.palette.size() * sizeof(uint32_t)
+            + tile.rowOffsets.size() * sizeof(uint32_t)
+            + tile.runStarts.size() * sizeof(uint8_t)
+            + tile.runLabels.size() * sizeof(uint16_t);
+    }
+    return bytes;
+}
+
+bool SegmentationMask::isTileValid(const MaskTile& tile, uint32_t validHeight) {
+    if (tile.rowOffsets.size() != kTileSize + 1 || tile.rowOffsets.front() != 0
+        || tile.runStarts.size() != tile.runLabels.size() || tile.rowOffsets.back() != tile.runStarts.size()) {
+        return false;
+    }
+
+    for (uint16_t entry : tile.runLabels) {
+        if (entry >= tile.palette.size()) {
+            return false;
+        }
+    }
+
+    for (uint32_t y = 0; y < kTileSize; y++) {
+        const uint32_t first = tile.rowOffsets[y];
+        const uint32_t last = tile.rowOffsets[y + 1];
+        if (first > last) {
+            return false;
+        }
+
+        // Picking needs a run at column 0 and strictly increasing starts
+        if (y < validHeight && (first == last || tile.runStarts[first] != 0)) {
+            return false;
+        }
+        for (uint32_t run = first + 1; run < last; run++) {
+            if (tile.runStarts[run] <= tile.runStarts[run - 1]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool SegmentationMask::isCellTableValid() const {
+    // findCell() binary searches by label; the spatial index trusts the bounding boxes
+    for (size_t i = 0; i < m_cells.size(); i++) {
+        const CellInfo& cell = m_cells[i];
+        if (cell.label == 0 || (i > 0 && cell.label <= m_cells[i - 1].label)
+            || cell.minX > cell.maxX || cell.minY > cell.maxY || cell.maxX >= m_width || cell.maxY >= m_height) {
+            return false;
+        }
+    }
+
+    for (const MaskTile& tile : m_tiles) {
+        for (uint32_t label : tile.palette) {
+            if (label != 0 && !findCell(label)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void SegmentationMask::buildSpatialIndex() {
+    m_gridWidth = (m_width + kGridCellSize - 1) / kGridCellSize;
+    m_gridHeight = (m_height + kGridCellSize - 1) / kGridCellSize;
+    const size_t bucketCount = static_cast<size_t>(m_gridWidth) * m_gridHeight;
+
+    // Two passes: count per bucket, then fill (CSR)
+    m_gridOffsets.assign(bucketCount + 1, 0);
+    for (const CellInfo& cell : m_cells) {
+        for (uint32_t gy = cell.minY / kGridCellSize; gy <= cell.maxY / kGridCellSize; gy++) {
+            for (uint32_t gx = cell.minX / kGridCellSize; gx <= cell.maxX / kGridCellSize; gx++) {
+                m_gridOffsets[static_cast<size_t>(gy) * m_gridWidth + gx + 1]++;
+            }
+        }
+    }
+    for (size_t i = 0; i < bucketCount; i++) {
+        m_gridOffsets[i + 1] += m_gridOffsets[i];
+    }
+
+    m_gridCells.resize(m_gridOffsets.back());
+    std::vector<uint32_t> cursor(m_gridOffsets.begin(), m_gridOffsets.end() - 1);
+    for (size_t index = 0; index < m_cells.size(); index++) {
+        const CellInfo& cell = m_cells[index];
+        for (uint32_t gy = cell.minY / kGridCellSize; gy <= cell.maxY / kGridCellSize; gy++) {
+            for (uint32_t gx = cell.minX / kGridCellSize; gx <= cell.maxX / kGridCellSize; gx++) {
+                m_gridCells[cursor[static_cast<size_t>(gy) * m_gridWidth + gx]++] = static_cast<uint32_t>(index);
+            }
+        }
+    }
+}
+
+void SegmentationMask::gatherCandidates(uint32_t minX, uint32_t minY, uint32_t maxX, uint32_t maxY,
+                                        std::vector<uint32_t>& candidates) const {
+    const uint32_t gx0 = minX / kGridCellSize;
+    const uint32_t gy0 = minY / kGridCellSize;
+    const uint32_t gx1 = maxX / kGridCellSize;
+    const uint32_t gy1 = maxY / kGridCellSize;
+
+    for (uint32_t gy = gy0; gy <= gy1; gy++) {
+        for (uint32_t gx = gx0; gx <= gx1; gx++) {
+            const size_t bucket = static_cast<size_t>(gy) * m_gridWidth + gx;
+            for (uint32_t i = m_gridOffsets[bucket]; i < m_gridOffsets[bucket + 1]; i++) {
+                const uint32_t index = m_gridCells[i];
+                const CellInfo& cell = m_cells[index];
+
+                // A cell spanning several buckets is reported by the first one the query visits
+                const uint32_t ownerX = std::max(cell.minX / kGridCellSize, gx0);
+                const uint32_t ownerY = std::max(cell.minY / kGridCellSize, gy0);
+                if (ownerX == gx && ownerY == gy) {
+                    candidates.push_back(index);
+                }
+            }
+        }
+    }
+}
+
+} // namespace ct
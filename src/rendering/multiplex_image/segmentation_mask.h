@@ -0,0 +1,141 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace ct {
+
+/// Read access to a full-resolution uint32 cell label mask (0 = background)
+/// Implementations must be safe to call concurrently
+class LabelSource {
+public:
+    virtual ~LabelSource() = default;
+
+    [[nodiscard]] virtual uint32_t getWidth() const = 0;
+    [[nodiscard]] virtual uint32_t getHeight() const = 0;
+
+    /// Read a rectangle of labels
+    /// @param rowStride Distance between output rows, in pixels
+    /// @return true if the region was read
+    virtual bool readRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                            uint32_t* destination, size_t rowStride) const = 0;
+};
+
+/// Per-cell geometry derived from the mask
+struct CellInfo {
+    uint32_t label = 0;
+    uint32_t minX = 0;          // Inclusive bounding box, in pixels
+    uint32_t minY = 0;
+    uint32_t maxX = 0;
+    uint32_t maxY = 0;
+    uint64_t area = 0;          // Pixel count
+    glm::vec2 centroid{0.0f};
+};
+
+/// One horizontal run of a labelled cell within a mask tile
+struct LabelRun {
+    uint32_t label = 0;
+    uint16_t y = 0;             // Row within the tile
+    uint16_t x = 0;             // First column within the tile
+    uint16_t length = 0;
+};
+
+/// Cell segmentation mask stored as tiled, run-length encoded labels
+///
+/// Each 256x256 tile keeps a palette of the labels it contains and encodes every row as
+/// (start column, palette index) runs, so picking a pixel is a binary search within one row.
+/// Cells are indexed by a uniform grid over their bounding boxes for region queries.
+class SegmentationMask {
+public:
+    static constexpr uint32_t kTileSize = 256;
+
+    SegmentationMask() = default;
+
+    /// Encode a label mask and compute per-cell bounds and centroids in parallel
+    /// @param source Full-resolution labels
+    /// @param threadCount Worker threads (0 = all hardware threads)
+    /// @return true if the mask was built
+    bool build(const LabelSource& source, uint32_t threadCount = 0);
+
+    /// Write the encoded mask and cell table to disk
+    bool save(const std::filesystem::path& path) const;
+
+    /// Read a mask written by save()
+    bool load(const std::filesystem::path& path);
+
+    /// Get the label under a pixel (0 for background or out of bounds)
+    [[nodiscard]] uint32_t pickCell(uint32_t x, uint32_t y) const;
+
+    /// Find cells whose centroid lies inside a polygon (even-odd rule), in pixel coordinates
+    void queryPolygon(const std::vector<glm::vec2>& polygon, std::vector<uint32_t>& labels) const;
+
+    /// Find cells whose bounding box overlaps a rectangle (inclusive pixel bounds)
+    void queryRect(uint32_t minX, uint32_t minY, uint32_t maxX, uint32_t maxY, std::vector<uint32_t>& labels) const;
+
+    /// Look up a cell by label
+    /// @return Cell info, or nullptr if the label does not occur in the mask
+    [[nodiscard]] const CellInfo* findCell(uint32_t label) const;
+
+    /// Expand one tile to raw labels for GPU upload (edge tiles are padded with 0)
+    /// @param destination Receives kTileSize * kTileSize labels
+    void decodeTile(uint32_t tileX, uint32_t tileY, uint32_t* destination) const;
+
+    /// Get the foreground runs of one tile in row order (background is skipped)
+    void getTileRuns(uint32_t tileX, uint32_t tileY, std::vector<LabelRun>& runs) const;
+
+    /// Pack selected labels into the bitset read by shaders/cell_outline.frag
+    static void buildSelectionBits(const std::vector<uint32_t>& labels, uint32_t maxLabel, std::vector<uint32_t>& bits);
+
+    [[nodiscard]] uint32_t getWidth() const { return m_width; }
+    [[nodiscard]] uint32_t getHeight() const { return m_height; }
+    [[nodiscard]] uint32_t getTilesX() const { return m_tilesX; }
+    [[nodiscard]] uint32_t getTilesY() const { return m_tilesY; }
+    [[nodiscard]] const std::vector<CellInfo>& getCells() const { return m_cells; }
+    [[nodiscard]] uint32_t getMaxLabel() const { return m_cells.empty() ? 0 : m_cells.back().label; }
+
+    /// Get the encoded size in bytes (runs, palettes and row offsets)
+    [[nodiscard]] size_t getEncodedBytes() const;
+
+private:
+    /// One encoded tile
+    struct MaskTile {
+        std::vector<uint32_t> palette;      // Labels present in this tile
+        std::vector<uint32_t> rowOffsets;   // kTileSize + 1 offsets into the run arrays
+        std::vector<uint8_t> runStarts;     // First column of each run
+        std::vector<uint16_t> runLabels;    // Palette index of each run
+    };
+
+    /// Check a loaded tile's run structure so lookups cannot index out of bounds
+    /// @param validHeight Rows of the tile inside the image (each must start with a run at column 0)
+    static bool isTileValid(const MaskTile& tile, uint32_t validHeight);
+
+    /// Check the loaded cell table against the image size and the tile palettes
+    bool isCellTableValid() const;
+
+    /// Bucket cells by bounding box into the uniform grid
+    void buildSpatialIndex();
+
+    /// Collect candidate cell indices from grid buckets overlapping a rectangle
+    void gatherCandidates(uint32_t minX, uint32_t minY, uint32_t maxX, uint32_t maxY,
+                          std::vector<uint32_t>& candidates) const;
+
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    uint32_t m_tilesX = 0;
+    uint32_t m_tilesY = 0;
+    std::vector<MaskTile> m_tiles;
+    std::vector<CellInfo> m_cells;              // Sorted by label
+
+    // Uniform grid over cell bounding boxes (CSR layout)
+    static constexpr uint32_t kGridCellSize = 512;
+    uint32_t m_gridWidth = 0;
+    uint32_t m_gridHeight = 0;
+    std::vector<uint32_t> m_gridOffsets;
+    std::vector<uint32_t> m_gridCells;          // Indices into m_cells
+};
+
+} // namespace ct
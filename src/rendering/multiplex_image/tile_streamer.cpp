@@ -0,0 +1,388 @@
+#include "rendering/multiplex_image/tile_streamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace ct {
+
+namespace {
+
+constexpr double kLatencyBucketsPerOctave = 8.0;
+
+} // namespace
+
+void LatencyHistogram::record(double ms) {
+    size_t bucket = 0;
+    if (ms >= kMinMs) {
+        const double index = std::floor(std::log2(ms / kMinMs) * kLatencyBucketsPerOctave) + 1.0;
+        bucket = std::min(kBucketCount - 1, static_cast<size_t>(index));
+    }
+    buckets[bucket]++;
+    count++;
+    maxMs = std::max(maxMs, ms);
+}
+
+double LatencyHistogram::percentile(double fraction) const {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    const auto rank = static_cast<uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(count)));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < kBucketCount; bucket++) {
+        seen += buckets[bucket];
+        if (seen >= std::max<uint64_t>(rank, 1)) {
+            if (bucket == 0) {
+                return 0.0;
+            }
+            // Geometric middle of the bucket; the top bucket is open-ended
+            const double middle = kMinMs * std::exp2((static_cast<double>(bucket) - 0.5) / kLatencyBucketsPerOctave);
+            return std::min(middle, maxMs);
+        }
+    }
+    return maxMs;
+}
+
+TileStreamer::~TileStreamer() {
+    shutdown();
+}
+
+bool TileStreamer::initialize(TileDecoder& decoder, const TileStreamerConfig& config) {
+    if (!m_workers.empty()) {
+        return true;
+    }
+
+    m_decoder = &decoder;
+    m_config = config;
+
+    if (m_config.workerCount == 0) {
+        // Leave a core for the render thread
+        const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        m_config.workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    // Every worker holds a slot while it waits for work, so leave room for finished tiles too
+    if (m_config.stagingSlots <= m_config.workerCount) {
+        std::cerr << "Tile streamer needs more staging slots (" << m_config.stagingSlots
+                  << ") than decode workers (" << m_config.workerCount << ")\n";
+        return false;
+    }
+
+    const size_t tileBytes = static_cast<size_t>(decoder.getTileSize()) * decoder.getTileSize() * sizeof(uint16_t);
+    if (!m_staging.initialize(tileBytes, m_config.stagingSlots)) {
+        return false;
+    }
+
+    m_stopping = false;
+    m_workers.reserve(m_config.workerCount);
+    for (uint32_t i = 0; i < m_config.workerCount; i++) {
+        m_workers.emplace_back(&TileStreamer::workerLoop, this);
+    }
+
+    std::cout << "Tile streamer started: " << m_config.workerCount << " decode worker(s), "
+              << m_config.stagingSlots << " staging slot(s)\n";
+    return true;
+}
+
+void TileStreamer::shutdown() {
+    if (m_workers.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_workAvailable.notify_all();
+    m_staging.shutdown();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+
+    // Tiles still waiting count at the time they spent in view
+    recordUndelivered(m_visibleSince, Clock::now(), m_stats);
+
+    m_queue.clear();
+    m_requests.clear();
+    m_resident.clear();
+    m_failed.clear();
+    m_visible.clear();
+    m_visibleSince.clear();
+    m_ready.clear();
+    m_hasPreviousView = false;
+}
+
+void TileStreamer::setChannels(const std::vector<uint32_t>& channels) {
+    m_config.channels = channels;
+}
+
+void TileStreamer::updateView(const TileViewState& view) {
+    if (!m_decoder) {
+        return;
+    }
+
+    const TileViewState predicted = predictView(view);
+
+    std::vector<TileKey> visibleTiles;
+    std::vector<TileKey> wantedTiles;
+    computeViewTiles(*m_decoder, view, 0, m_config.channels, visibleTiles);
+    computeViewTiles(*m_decoder, view, m_config.prefetchMargin, m_config.channels, wantedTiles);
+    computeViewTiles(*m_decoder, predicted, m_config.prefetchMargin, m_config.channels, wantedTiles);
+
+    const double tileSize = m_decoder->getTileSize();
+    const auto screenDistance = [&](const TileKey& key) {
+        const double span = tileSize * std::ldexp(1.0, static_cast<int>(key.level));
+        const double dx = (key.x + 0.5) * span - view.centerX;
+        const double dy = (key.y + 0.5) * span - view.centerY;
+        return std::sqrt(dx * dx + dy * dy) * view.zoom;
+    };
+
+    const auto now = Clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::unordered_set<TileKey, TileKeyHash> visible(visibleTiles.begin(), visibleTiles.end());
+        for (const TileKey& key : visibleTiles) {
+            if (m_visible.count(key)) {
+                continue;
+            }
+            if (m_resident.count(key)) {
+                m_stats.prefetchHits++;
+                m_stats.visibleLatency.record(0.0);
+            } else if (!m_failed.count(key)) {
+                m_visibleSince.emplace(key, now);
+            }
+        }
+
+        // Tiles that left the view before arriving waited at least as long as they were visible
+        for (auto it = m_visibleSince.begin(); it != m_visibleSince.end();) {
+            if (visible.count(it->first)) {
+                ++it;
+                continue;
+            }
+            m_stats.visibleLatency.record(std::chrono::duration<double, std::milli>(now - it->second).count());
+            m_stats.visibleUndelivered++;
+            it = m_visibleSince.erase(it);
+        }
+        m_visible = std::move(visible);
+
+        std::unordered_map<TileKey, Band, TileKeyHash> wanted;
+        wanted.reserve(visibleTiles.size() + wantedTiles.size());
+        for (const TileKey& key : visibleTiles) {
+            wanted[key] = Band::Visible;
+        }
+        for (const TileKey& key : wantedTiles) {
+            wanted.emplace(key, Band::Predicted);
+        }
+
+        // Cancel queued work the camera no longer needs; in-flight decodes run to completion
+        for (auto it = m_requests.begin(); it != m_requests.end();) {
+            if (!it->second.inFlight && !wanted.count(it->first)) {
+                it = m_requests.erase(it);
+                m_stats.cancelled++;
+            } else {
+                ++it;
+            }
+        }
+
+        for (const auto& [key, band] : wanted) {
+            if (m_resident.count(key) || m_failed.count(key)) {
+                continue;
+            }
+            Request& request = m_requests[key];
+            request.band = band;
+            request.distance = screenDistance(key);
+        }
+
+        // Priorities shift every frame, so rebuilding the heap beats updating it in place
+        m_queue.clear();
+        for (const auto& [key, request] : m_requests) {
+            if (!request.inFlight) {
+                m_queue.push_back({request.band, request.distance, key});
+            }
+        }
+        std::make_heap(m_queue.begin(), m_queue.end(), lowerPriority);
+    }
+
+    m_workAvailable.notify_all();
+}
+
+void TileStreamer::collectReady(std::vector<ReadyTile>& tiles) {
+    const auto now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (ReadyTile& tile : m_ready) {
+        auto since = m_visibleSince.find(tile.key);
+        if (since != m_visibleSince.end()) {
+            m_stats.visibleLatency.record(std::chrono::duration<double, std::milli>(now - since->second).count());
+            m_visibleSince.erase(since);
+        }
+        tiles.push_back(tile);
+    }
+    m_ready.clear();
+}
+
+void TileStreamer::releaseTile(const ReadyTile& tile) {
+    m_staging.release(tile.slot);
+}
+
+void TileStreamer::evict(const TileKey& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_resident.erase(key);
+}
+
+bool TileStreamer::isResident(const TileKey& key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_resident.count(key) != 0;
+}
+
+bool TileStreamer::isBusy() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_requests.empty() || !m_ready.empty();
+}
+
+TileStreamStats TileStreamer::getStats() const {
+    const auto now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TileStreamStats stats = m_stats;
+    recordUndelivered(m_visibleSince, now, stats);
+    return stats;
+}
+
+void TileStreamer::recordUndelivered(
+    const std::unordered_map<TileKey, Clock::time_point, TileKeyHash>& visibleSince, Clock::time_point now,
+    TileStreamStats& stats) {
+    for (const auto& [key, since] : visibleSince) {
+        stats.visibleLatency.record(std::chrono::duration<double, std::milli>(now - since).count());
+        stats.visibleUndelivered++;
+    }
+}
+
+void TileStreamer::computeViewTiles(const TileDecoder& decoder, const TileViewState& view, uint32_t margin,
+                                    const std::vector<uint32_t>& channels, std::vector<TileKey>& tiles) {
+    const uint32_t levelCount = decoder.getLevelCount();
+    if (levelCount == 0 || view.zoom <= 0.0 || view.viewportWidth == 0 || view.viewportHeight == 0) {
+        return;
+    }
+
+    // Finest level whose pixels are no smaller than a screen pixel
+    uint32_t level = 0;
+    if (view.zoom < 1.0) {
+        level = std::min(levelCount - 1, static_cast<uint32_t>(std::floor(std::log2(1.0 / view.zoom))));
+    }
+
+    const PyramidLevel info = decoder.getLevel(level);
+    const double span = decoder.getTileSize() * std::ldexp(1.0, static_cast<int>(level));
+    const double halfWidth = view.viewportWidth / (2.0 * view.zoom);
+    const double halfHeight = view.viewportHeight / (2.0 * view.zoom);
+
+    const auto tileRange = [&](double low, double high, uint32_t count, int64_t& first, int64_t& last) {
+        first = static_cast<int64_t>(std::floor(low / span)) - margin;
+        last = static_cast<int64_t>(std::floor(high / span)) + margin;
+        first = std::max<int64_t>(first, 0);
+        last = std::min<int64_t>(last, static_cast<int64_t>(count) - 1);
+    };
+
+    int64_t x0, x1, y0, y1;
+    tileRange(view.centerX - halfWidth, view.centerX + halfWidth, info.tilesX, x0, x1);
+    tileRange(view.centerY - halfHeight, view.centerY + halfHeight, info.tilesY, y0, y1);
+
+    for (uint32_t channel : channels) {
+        for (int64_t y = y0; y <= y1; y++) {
+            for (int64_t x = x0; x <= x1; x++) {
+                tiles.push_back({level, channel, static_cast<uint32_t>(x), static_cast<uint32_t>(y)});
+            }
+        }
+    }
+}
+
+bool TileStreamer::lowerPriority(const QueueEntry& a, const QueueEntry& b) {
+    if (a.band != b.band) {
+        return a.band > b.band;
+    }
+    return a.distance > b.distance;
+}
+
+TileViewState TileStreamer::predictView(const TileViewState& view) {
+    if (m_hasPreviousView && view.time > m_previousView.time && m_previousView.zoom > 0.0 && view.zoom > 0.0) {
+        const double dt = view.time - m_previousView.time;
+        const double velocityX = (view.centerX - m_previousView.centerX) / dt;
+        const double velocityY = (view.centerY - m_previousView.centerY) / dt;
+        const double zoomRate = std::log(view.zoom / m_previousView.zoom) / dt;
+
+        // Exponential smoothing damps single-frame input jitter
+        constexpr double smoothing = 0.5;
+        m_velocityX += (velocityX - m_velocityX) * smoothing;
+        m_velocityY += (velocityY - m_velocityY) * smoothing;
+        m_zoomRate += (zoomRate - m_zoomRate) * smoothing;
+    }
+
+    m_previousView = view;
+    m_hasPreviousView = true;
+
+    TileViewState predicted = view;
+    predicted.time += m_config.predictionSeconds;
+    predicted.centerX += m_velocityX * m_config.predictionSeconds;
+    predicted.centerY += m_velocityY * m_config.predictionSeconds;
+    predicted.zoom *= std::exp(m_zoomRate * m_config.predictionSeconds);
+    return predicted;
+}
+
+void TileStreamer::workerLoop() {
+    for (;;) {
+        // Holding a slot before taking work guarantees the decode has somewhere to go
+        const uint32_t slot = m_staging.acquire();
+        if (slot == StagingBufferPool::kInvalidSlot) {
+            return;
+        }
+
+        TileKey key;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workAvailable.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+
+            if (m_stopping) {
+                lock.unlock();
+                m_staging.release(slot);
+                return;
+            }
+
+            std::pop_heap(m_queue.begin(), m_queue.end(), lowerPriority);
+            key = m_queue.back().key;
+            m_queue.pop_back();
+            m_requests[key].inFlight = true;
+        }
+
+        auto* pixels = static_cast<uint16_t*>(m_staging.getSlotData(slot));
+        const bool decoded = m_decoder->decodeTile(key, pixels);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_requests.erase(key);
+
+            // A corrupt or unreadable tile would fail again; stop asking for it
+            if (!decoded) {
+                m_stats.failed++;
+                m_failed.insert(key);
+                m_visibleSince.erase(key);
+                m_staging.release(slot);
+                continue;
+            }
+
+            m_stats.decoded++;
+            m_resident.insert(key);
+            m_ready.push_back({key, slot, pixels, m_staging.getSlotOffset(slot)});
+        }
+
+        if (m_config.onTileReady) {
+            m_config.onTileReady();
+        }
+    }
+}
+
+} // namespace ct
@@ -0,0 +1,245 @@
+#pragma once
+
+#include "rendering/multiplex_image/image_pyramid.h"
+#include "rendering/staging_buffer_pool.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ct {
+
+/// Identifies one tile of one channel at one pyramid level
+struct TileKey {
+    uint32_t level = 0;
+    uint32_t channel = 0;
+    uint32_t x = 0;
+    uint32_t y = 0;
+
+    bool operator==(const TileKey&) const = default;
+};
+
+struct TileKeyHash {
+    size_t operator()(const TileKey& key) const {
+        uint64_t packed = (static_cast<uint64_t>(key.level) << 56) ^ (static_cast<uint64_t>(key.channel) << 48)
+            ^ (static_cast<uint64_t>(key.y) << 24) ^ key.x;
+        packed ^= packed >> 33;
+        packed *= 0xFF51AFD7ED558CCDull;
+        packed ^= packed >> 33;
+        return std::hash<uint64_t>{}(packed);
+    }
+};
+
+/// Decodes tiles straight into caller-provided memory
+/// Implementations must be safe to call from several worker threads at once
+class TileDecoder {
+public:
+    virtual ~TileDecoder() = default;
+
+    /// Get the tile edge length in pixels
+    [[nodiscard]] virtual uint32_t getTileSize() const = 0;
+
+    /// Get the number of pyramid levels
+    [[nodiscard]] virtual uint32_t getLevelCount() const = 0;
+
+    /// Get the dimensions of a level
+    [[nodiscard]] virtual PyramidLevel getLevel(uint32_t level) const = 0;
+
+    /// Decode one tile
+    /// @param destination Receives tileSize * tileSize uint16 pixels
+    /// @return true if the tile was decoded
+    virtual bool decodeTile(const TileKey& key, uint16_t* destination) = 0;
+};
+
+/// TileDecoder backed by an ImagePyramid (source tiles for level 0, sidecar tiles above)
+class PyramidTileDecoder : public TileDecoder {
+public:
+    explicit PyramidTileDecoder(const ImagePyramid& pyramid) : m_pyramid(pyramid) {}
+
+    [[nodiscard]] uint32_t getTileSize() const override { return m_pyramid.getTileSize(); }
+    [[nodiscard]] uint32_t getLevelCount() const override { return m_pyramid.getLevelCount(); }
+    [[nodiscard]] PyramidLevel getLevel(uint32_t level) const override { return m_pyramid.getLevel(level); }
+    bool decodeTile(const TileKey& key, uint16_t* destination) override {
+        return m_pyramid.readTile(key.level, key.channel, key.x, key.y, destination);
+    }
+
+private:
+    const ImagePyramid& m_pyramid;
+};
+
+/// Camera state for one frame, in level-0 pixel coordinates
+struct TileViewState {
+    double time = 0.0;              // Seconds, monotonic
+    double centerX = 0.0;
+    double centerY = 0.0;
+    double zoom = 1.0;              // Screen pixels per level-0 pixel
+    uint32_t viewportWidth = 0;
+    uint32_t viewportHeight = 0;
+};
+
+/// Configuration for the tile streamer
+struct TileStreamerConfig {
+    uint32_t workerCount = 0;           // Decode threads (0 = hardware threads - 1)
+    uint32_t stagingSlots = 64;         // Tiles that can wait for upload at once
+    double predictionSeconds = 0.25;    // How far ahead camera motion is extrapolated
+    uint32_t prefetchMargin = 1;        // Ring of tiles around the view that is prefetched
+    std::vector<uint32_t> channels = {0};
+    std::function<void()> onTileReady;  // Called from a decode worker after each tile (e.g. Engine::requestRedraw)
+};
+
+/// A decoded tile waiting for upload; pixels live in a staging slot until releaseTile()
+struct ReadyTile {
+    TileKey key;
+    uint32_t slot = StagingBufferPool::kInvalidSlot;
+    const uint16_t* pixels = nullptr;
+    size_t stagingOffset = 0;
+};
+
+/// Fixed-size log-scale histogram of latencies in milliseconds
+/// Buckets grow by 2^(1/8), so percentiles are within about 5% of the true value.
+struct LatencyHistogram {
+    static constexpr size_t kBucketCount = 160;
+    static constexpr double kMinMs = 0.01;      // Bucket 0 holds everything below this (prefetch hits)
+
+    std::array<uint64_t, kBucketCount> buckets{};
+    uint64_t count = 0;
+    double maxMs = 0.0;
+
+    /// Add one sample
+    void record(double ms);
+
+    /// Get the latency below which the given fraction of samples fall
+    /// @param fraction In [0, 1]
+    /// @return Milliseconds, or 0 if there are no samples
+    [[nodiscard]] double percentile(double fraction) const;
+};
+
+/// Streaming statistics since initialization
+struct TileStreamStats {
+    LatencyHistogram visibleLatency;        // Time from a tile becoming visible to being ready (0 for prefetch hits)
+    size_t visibleUndelivered = 0;          // Visible tiles not ready yet or gone from view before arriving;
+                                            // recorded in visibleLatency at their time in view so far
+    size_t prefetchHits = 0;                // Tiles already resident when they became visible
+    size_t decoded = 0;
+    size_t cancelled = 0;                   // Queued requests dropped before decoding
+    size_t failed = 0;                      // Tiles the decoder could not produce; each is tried once
+};
+
+/// Priority-driven tile decode pool with motion-based prefetch
+///
+/// Each updateView() recomputes the wanted set: tiles visible now come first (nearest
+/// to the view center first), then tiles the extrapolated camera will need. Queued
+/// tiles that fall out of the wanted set are cancelled. Workers decode directly into
+/// pooled staging memory, which the renderer copies to the GPU and hands back.
+class TileStreamer {
+public:
+    TileStreamer() = default;
+    ~TileStreamer();
+
+    // Non-copyable
+    TileStreamer(const TileStreamer&) = delete;
+    TileStreamer& operator=(const TileStreamer&) = delete;
+
+    /// Start the decode workers
+    /// @param decoder Tile source (must outlive the streamer)
+    /// @param config Streamer configuration settings
+    /// @return true if initialization succeeded
+    bool initialize(TileDecoder& decoder, const TileStreamerConfig& config = {});
+
+    /// Stop and join the decode workers
+    void shutdown();
+
+    /// Set which channels are being displayed
+    void setChannels(const std::vector<uint32_t>& channels);
+
+    /// Recompute wanted tiles for a new camera state and reprioritize the queue
+    void updateView(const TileViewState& view);
+
+    /// Take every tile decoded since the last call (render thread)
+    void collectReady(std::vector<ReadyTile>& tiles);
+
+    /// Return a tile's staging slot after its upload was recorded
+    void releaseTile(const ReadyTile& tile);
+
+    /// Forget a resident tile after the GPU cache dropped it
+    void evict(const TileKey& key);
+
+    /// Check whether a tile has been delivered and not evicted
+    [[nodiscard]] bool isResident(const TileKey& key) const;
+
+    /// Check whether any tile is queued, decoding or waiting for collection
+    [[nodiscard]] bool isBusy() const;
+
+    /// Get a copy of the streaming statistics
+    [[nodiscard]] TileStreamStats getStats() const;
+
+    /// Compute the tiles covering a view, expanded by a margin, at the view's natural level
+    /// @param margin Extra tiles on every side
+    static void computeViewTiles(const TileDecoder& decoder, const TileViewState& view, uint32_t margin,
+                                 const std::vector<uint32_t>& channels, std::vector<TileKey>& tiles);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /// Priority band: visible tiles always beat predicted ones
+    enum class Band : uint8_t { Visible = 0, Predicted = 1 };
+
+    struct Request {
+        Band band = Band::Predicted;
+        double distance = 0.0;          // Screen-space distance from the view center
+        bool inFlight = false;
+    };
+
+    struct QueueEntry {
+        Band band;
+        double distance;
+        TileKey key;
+    };
+
+    /// Heap ordering: lowest band, then nearest first
+    static bool lowerPriority(const QueueEntry& a, const QueueEntry& b);
+
+    /// Extrapolate the camera forward by the prediction horizon
+    TileViewState predictView(const TileViewState& view);
+
+    /// Record visible tiles that have not arrived at their time in view so far (mutex held)
+    static void recordUndelivered(const std::unordered_map<TileKey, Clock::time_point, TileKeyHash>& visibleSince,
+                                  Clock::time_point now, TileStreamStats& stats);
+
+    /// Decode worker entry point
+    void workerLoop();
+
+    TileDecoder* m_decoder = nullptr;
+    TileStreamerConfig m_config;
+    StagingBufferPool m_staging;
+    std::vector<std::thread> m_workers;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workAvailable;
+    std::vector<QueueEntry> m_queue;                                    // Binary heap
+    std::unordered_map<TileKey, Request, TileKeyHash> m_requests;
+    std::unordered_set<TileKey, TileKeyHash> m_resident;
+    std::unordered_set<TileKey, TileKeyHash> m_failed;                  // Not requested again until re-initialized
+    std::unordered_set<TileKey, TileKeyHash> m_visible;
+    std::unordered_map<TileKey, Clock::time_point, TileKeyHash> m_visibleSince;
+    std::vector<ReadyTile> m_ready;
+    TileStreamStats m_stats;
+    bool m_stopping = false;
+
+    // Camera motion estimate (render thread only)
+    bool m_hasPreviousView = false;
+    TileViewState m_previousView;
+    double m_velocityX = 0.0;
+    double m_velocityY = 0.0;
+    double m_zoomRate = 0.0;            // d(log zoom)/dt
+};
+
+} // namespace ct
@@ -0,0 +1,1259 @@
+#include "rendering/render_graph.h"
+#include "rendering/vulkan_context.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace ct {
+
+namespace {
+
+constexpr uint32_t kGraphicsQueue = 0;
+constexpr uint32_t kComputeQueue = 1;
+
+/// Synchronization scope of a resource usage
+struct UsageInfo {
+    VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+    VkAccessFlags2 readAccess = VK_ACCESS_2_NONE;
+    VkAccessFlags2 writeAccess = VK_ACCESS_2_NONE;
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;   // UNDEFINED = buffer-only usage
+    VkImageUsageFlags imageUsage = 0;
+};
+
+UsageInfo getUsageInfo(ResourceUsage usage) {
+    constexpr VkPipelineStageFlags2 kDepthStages =
+        VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+
+    switch (usage) {
+        case ResourceUsage::ColorAttachment:
+            return {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT,
+                    VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT};
+        case ResourceUsage::DepthAttachment:
+            return {kDepthStages, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                    VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT};
+        case ResourceUsage::DepthRead:
+            return {kDepthStages, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_ACCESS_2_NONE,
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT};
+        case ResourceUsage::SampledFragment:
+            return {VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_ACCESS_2_NONE,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT};
+        case ResourceUsage::SampledCompute:
+            return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_ACCESS_2_NONE,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT};
+        case ResourceUsage::StorageCompute:
+            return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                    VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT};
+        case ResourceUsage::TransferSource:
+            return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_ACCESS_2_NONE,
+                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT};
+        case ResourceUsage::TransferDestination:
+            return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_NONE, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT};
+        case ResourceUsage::VertexBuffer:
+            return {VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT};
+        case ResourceUsage::IndexBuffer:
+            return {VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT};
+        case ResourceUsage::UniformBuffer:
+            return {VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT |
+                        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                    VK_ACCESS_2_UNIFORM_READ_BIT};
+        case ResourceUsage::IndirectBuffer:
+            return {VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT};
+    }
+    return {};
+}
+
+/// Check whether a usage applies to buffers (storage and transfer apply to both)
+bool isBufferUsage(ResourceUsage usage) {
+    switch (usage) {
+        case ResourceUsage::StorageCompute:
+        case ResourceUsage::TransferSource:
+        case ResourceUsage::TransferDestination:
+        case ResourceUsage::VertexBuffer:
+        case ResourceUsage::IndexBuffer:
+        case ResourceUsage::UniformBuffer:
+        case ResourceUsage::IndirectBuffer:
+            return true;
+        default:
+            return false;
+    }
+}
+
+VkImageAspectFlags getAspectMask(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+        case VK_FORMAT_D32_SFLOAT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT;
+        case VK_FORMAT_S8_UINT:
+            return VK_IMAGE_ASPECT_STENCIL_BIT;
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        default:
+            return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+} // namespace
+
+void RenderPassBuilder::read(RenderResource resource, ResourceUsage usage) {
+    add(resource, usage, false);
+}
+
+void RenderPassBuilder::write(RenderResource resource, ResourceUsage usage) {
+    add(resource, usage, true);
+}
+
+void RenderPassBuilder::add(RenderResource resource, ResourceUsage usage, bool write) {
+    // Reading and writing a resource the same way (e.g. a storage image) is one access
+    for (Access& access : m_accesses) {
+        if (access.resource == resource.index && access.usage == usage) {
+            access.write = access.write || write;
+            return;
+        }
+    }
+    m_accesses.push_back({resource.index, usage, write});
+}
+
+void RenderGraph::BarrierBatch::clear() {
+    images.clear();
+    imageResources.clear();
+    buffers.clear();
+    bufferResources.clear();
+    memory.clear();
+}
+
+RenderGraph::~RenderGraph() {
+    shutdown();
+}
+
+bool RenderGraph::initialize(const VulkanContext& context, const RenderGraphConfig& config) {
+    shutdown();
+
+    m_context = &context;
+    m_device = context.getDevice();
+    m_config = config;
+    m_config.framesInFlight = std::max(m_config.framesInFlight, 1u);
+
+    m_queues[kGraphicsQueue] = context.getGraphicsQueue();
+    m_queueFamilies[kGraphicsQueue] = context.getQueueFamilyIndices().graphicsFamily.value();
+    m_hasComputeQueue = config.asyncCompute && context.hasAsyncCompute();
+    if (m_hasComputeQueue) {
+        m_queues[kComputeQueue] = context.getComputeQueue();
+        m_queueFamilies[kComputeQueue] = context.getQueueFamilyIndices().computeFamily.value();
+    }
+    const uint32_t queueCount = m_hasComputeQueue ? 2 : 1;
+
+    for (uint32_t queue = 0; queue < queueCount; queue++) {
+        VkSemaphoreTypeCreateInfo typeInfo{};
+        typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &typeInfo;
+
+        if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_timelines[queue]) != VK_SUCCESS) {
+            std::cerr << "Failed to create render graph timeline semaphore\n";
+            shutdown();
+            return false;
+        }
+    }
+
+    m_frames.resize(m_config.framesInFlight);
+    for (FrameSlot& frame : m_frames) {
+        for (uint32_t queue = 0; queue < queueCount; queue++) {
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = m_queueFamilies[queue];
+
+            if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &frame.pools[queue]) != VK_SUCCESS) {
+                std::cerr << "Failed to create render graph command pool\n";
+                shutdown();
+                return false;
+            }
+        }
+    }
+
+    m_initialized = true;
+    std::cout << "Render graph initialized (" << m_config.framesInFlight << " frames in flight"
+              << (m_hasComputeQueue ? ", async compute" : "") << ")\n";
+    return true;
+}
+
+void RenderGraph::shutdown() {
+    if (m_device == VK_NULL_HANDLE) {
+        return;
+    }
+
+    reset();
+
+    for (FrameSlot& frame : m_frames) {
+        for (VkCommandPool& pool : frame.pools) {
+            if (pool != VK_NULL_HANDLE) {
+                vkDestroyCommandPool(m_device, pool, nullptr);
+                pool = VK_NULL_HANDLE;
+            }
+        }
+    }
+    m_frames.clear();
+
+    for (VkSemaphore& timeline : m_timelines) {
+        if (timeline != VK_NULL_HANDLE) {
+            vkDestroySemaphore(m_device, timeline, nullptr);
+            timeline = VK_NULL_HANDLE;
+        }
+    }
+
+    m_timelineValues = {};
+    m_queues = {};
+    m_hasComputeQueue = false;
+    m_frameIndex = 0;
+    m_context = nullptr;
+    m_device = VK_NULL_HANDLE;
+    m_initialized = false;
+}
+
+void RenderGraph::reset() {
+    releaseCompiled();
+    m_passes.clear();
+    m_resources.clear();
+}
+
+RenderResource RenderGraph::createImage(const std::string& name, const RenderImageDesc& desc) {
+    releaseCompiled();
+
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    m_resources.push_back(std::move(resource));
+    return {static_cast<uint32_t>(m_resources.size() - 1)};
+}
+
+RenderResource RenderGraph::importImage(const std::string& name, const RenderImageDesc& desc, VkImage image,
+                                        VkImageView view, const ImportedResourceState& initial,
+                                        const ImportedResourceState& final, bool concurrent) {
+    releaseCompiled();
+
+    Resource resource;
+    resource.name = name;
+    resource.imported = true;
+    resource.desc = desc;
+    resource.image = image;
+    resource.view = view;
+    resource.initial = initial;
+    resource.final = final;
+    resource.concurrent = concurrent;
+    m_resources.push_back(std::move(resource));
+    return {static_cast<uint32_t>(m_resources.size() - 1)};
+}
+
+RenderResource RenderGraph::importBuffer(const std::string& name, VkBuffer buffer, VkDeviceSize size,
+                                         bool concurrent) {
+    releaseCompiled();
+
+    Resource resource;
+    resource.name = name;
+    resource.isImage = false;
+    resource.imported = true;
+    resource.concurrent = concurrent;
+    resource.buffer = buffer;
+    resource.bufferSize = size;
+    m_resources.push_back(std::move(resource));
+    return {static_cast<uint32_t>(m_resources.size() - 1)};
+}
+
+void RenderGraph::setImportedImage(RenderResource resource, VkImage image, VkImageView view) {
+    Resource& entry = m_resources[resource.index];
+    if (entry.imported && entry.isImage) {
+        entry.image = image;
+        entry.view = view;
+    }
+}
+
+void RenderGraph::setImportedBuffer(RenderResource resource, VkBuffer buffer) {
+    Resource& entry = m_resources[resource.index];
+    if (entry.imported && !entry.isImage) {
+        entry.buffer = buffer;
+    }
+}
+
+void RenderGraph::markOutput(RenderResource resource) {
+    releaseCompiled();
+    m_resources[resource.index].output = true;
+}
+
+void RenderGraph::addPass(const std::string& name, PassQueue queue,
+                          const std::function<void(RenderPassBuilder&)>& setup, PassExecute execute) {
+    releaseCompiled();
+
+    RenderPassBuilder builder;
+    if (setup) {
+        setup(builder);
+    }
+
+    Pass pass;
+    pass.name = name;
+    pass.queue = queue;
+    pass.accesses = std::move(builder.m_accesses);
+    pass.execute = std::move(execute);
+    pass.sideEffects = builder.m_sideEffects;
+    m_passes.push_back(std::move(pass));
+}
+
+bool RenderGraph::compile() {
+    if (!m_initialized) {
+        std::cerr << "Failed to compile render graph: not initialized\n";
+        return false;
+    }
+
+    releaseCompiled();
+
+    // Validate declarations
+    for (Pass& pass : m_passes) {
+        for (size_t i = 0; i < pass.accesses.size(); i++) {
+            const RenderPassBuilder::Access& access = pass.accesses[i];
+            if (access.resource >= m_resources.size()) {
+                std::cerr << "Failed to compile render graph: pass '" << pass.name << "' uses an invalid resource\n";
+                return false;
+            }
+
+            const Resource& resource = m_resources[access.resource];
+            const UsageInfo info = getUsageInfo(access.usage);
+            const bool usageFits = resource.isImage ? info.layout != VK_IMAGE_LAYOUT_UNDEFINED : isBufferUsage(access.usage);
+            const bool accessFits = access.write ? info.writeAccess != VK_ACCESS_2_NONE : info.readAccess != VK_ACCESS_2_NONE;
+            if (!usageFits || !accessFits) {
+                std::cerr << "Failed to compile render graph: pass '" << pass.name << "' cannot "
+                          << (access.write ? "write" : "read") << " '" << resource.name << "' with that usage\n";
+                return false;
+            }
+
+            for (size_t j = 0; j < i; j++) {
+                if (pass.accesses[j].resource == access.resource) {
+                    std::cerr << "Failed to compile render graph: pass '" << pass.name << "' uses '"
+                              << resource.name << "' in two different ways\n";
+                    return false;
+                }
+            }
+        }
+
+        pass.queueIndex = pass.queue == PassQueue::AsyncCompute && m_hasComputeQueue ? kComputeQueue : kGraphicsQueue;
+    }
+
+    std::vector<uint32_t> order(m_passes.size());
+    for (uint32_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+
+    cullPasses(order);
+    std::erase_if(order, [this](uint32_t pass) { return !m_passes[pass].active; });
+
+    // Lifetimes in live pass order
+    for (uint32_t position = 0; position < order.size(); position++) {
+        const Pass& pass = m_passes[order[position]];
+        for (const RenderPassBuilder::Access& access : pass.accesses) {
+            Resource& resource = m_resources[access.resource];
+            if (resource.firstPass == kNone) {
+                resource.firstPass = position;
+            }
+            resource.lastPass = position;
+            resource.queueMask |= 1u << pass.queueIndex;
+            resource.usage |= getUsageInfo(access.usage).imageUsage;
+        }
+    }
+
+    m_sharedAcrossQueues = std::any_of(m_resources.begin(), m_resources.end(),
+                                       [](const Resource& resource) { return resource.queueMask == 3u; });
+    m_importsOnCompute = std::any_of(m_resources.begin(), m_resources.end(), [](const Resource& resource) {
+        return resource.imported && (resource.queueMask & (1u << kComputeQueue));
+    });
+
+    // Queue family ownership is never transferred; the owner must have made shared imports concurrent
+    for (const Resource& resource : m_resources) {
+        if (resource.imported && !resource.concurrent && resource.queueMask == 3u &&
+            m_queueFamilies[kGraphicsQueue] != m_queueFamilies[kComputeQueue]) {
+            std::cerr << "Failed to compile render graph: '" << resource.name
+                      << "' is used on both queues but was not imported as concurrent\n";
+            releaseCompiled();
+            return false;
+        }
+    }
+
+    if (!allocateTransients()) {
+        releaseCompiled();
+        return false;
+    }
+
+    buildBatches(order);
+    planBarriers(order);
+
+    // One primary command buffer per submission per frame slot
+    std::array<uint32_t, kQueueCount> batchCounts{};
+    for (const Batch& batch : m_batches) {
+        batchCounts[batch.queueIndex]++;
+    }
+
+    for (FrameSlot& frame : m_frames) {
+        for (uint32_t queue = 0; queue < kQueueCount; queue++) {
+            if (batchCounts[queue] == 0) {
+                continue;
+            }
+
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = frame.pools[queue];
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = batchCounts[queue];
+
+            frame.commandBuffers[queue].resize(batchCounts[queue]);
+            if (vkAllocateCommandBuffers(m_device, &allocInfo, frame.commandBuffers[queue].data()) != VK_SUCCESS) {
+                std::cerr << "Failed to allocate render graph command buffers\n";
+                frame.commandBuffers[queue].clear();
+                releaseCompiled();
+                return false;
+            }
+        }
+    }
+
+    collectStats();
+    m_compiled = true;
+    return true;
+}
+
+void RenderGraph::cullPasses(const std::vector<uint32_t>& order) {
+    if (!m_config.cullPasses) {
+        for (Pass& pass : m_passes) {
+            pass.active = true;
+        }
+        return;
+    }
+
+    // Each access depends on the last earlier write of its resource. Writes depend on it too,
+    // since attachments and storage images load their previous contents.
+    std::vector<uint32_t> lastWriter(m_resources.size(), kNone);
+    std::vector<std::vector<uint32_t>> producers(m_passes.size());
+    std::vector<uint32_t> stack;
+
+    for (uint32_t index : order) {
+        Pass& pass = m_passes[index];
+        bool root = pass.sideEffects;
+
+        for (const RenderPassBuilder::Access& access : pass.accesses) {
+            if (lastWriter[access.resource] != kNone) {
+                producers[index].push_back(lastWriter[access.resource]);
+            }
+            const Resource& resource = m_resources[access.resource];
+            root = root || (access.write && (resource.imported || resource.output));
+        }
+        for (const RenderPassBuilder::Access& access : pass.accesses) {
+            if (access.write) {
+                lastWriter[access.resource] = index;
+            }
+        }
+
+        if (root) {
+            pass.active = true;
+            stack.push_back(index);
+        }
+    }
+
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        for (uint32_t producer : producers[index]) {
+            if (!m_passes[producer].active) {
+                m_passes[producer].active = true;
+                stack.push_back(producer);
+            }
+        }
+    }
+}
+
+bool RenderGraph::allocateTransients() {
+    std::vector<uint32_t> transients;
+
+    for (uint32_t index = 0; index < m_resources.size(); index++) {
+        Resource& resource = m_resources[index];
+        if (resource.imported || resource.firstPass == kNone) {
+            continue;
+        }
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = resource.desc.format;
+        imageInfo.extent = {resource.desc.width, resource.desc.height, 1};
+        imageInfo.mipLevels = resource.desc.mipLevels;
+        imageInfo.arrayLayers = resource.desc.arrayLayers;
+        imageInfo.samples = resource.desc.samples;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = resource.usage;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        // Shared between queue families without ownership transfers; the semaphores order the access
+        if (resource.queueMask == 3u && m_queueFamilies[kGraphicsQueue] != m_queueFamilies[kComputeQueue]) {
+            imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            imageInfo.queueFamilyIndexCount = 2;
+            imageInfo.pQueueFamilyIndices = m_queueFamilies.data();
+        } else {
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        }
+
+        if (vkCreateImage(m_device, &imageInfo, nullptr, &resource.image) != VK_SUCCESS) {
+            std::cerr << "Failed to create transient image '" << resource.name << "'\n";
+            return false;
+        }
+        transients.push_back(index);
+    }
+
+    // Place the largest images first; each goes at the lowest offset not used by an image that
+    // is alive at the same time. Images touched by async compute run off the graphics timeline,
+    // so they are never aliased.
+    struct Placement {
+        uint32_t resource;
+        VkDeviceSize alignment;
+        bool aliasable;
+    };
+
+    std::vector<Placement> placements;
+    std::vector<VkMemoryRequirements> requirements(m_resources.size());
+    for (uint32_t index : transients) {
+        Resource& resource = m_resources[index];
+        vkGetImageMemoryRequirements(m_device, resource.image, &requirements[index]);
+        resource.size = requirements[index].size;
+        m_stats.unaliasedTransientBytes += resource.size;
+
+        const bool aliasable = m_config.aliasTransients && resource.queueMask == (1u << kGraphicsQueue);
+        placements.push_back({index, requirements[index].alignment, aliasable});
+    }
+    std::stable_sort(placements.begin(), placements.end(), [this](const Placement& a, const Placement& b) {
+        return m_resources[a.resource].size > m_resources[b.resource].size;
+    });
+
+    const auto livesOverlap = [this](const Placement& a, const Placement& b) {
+        if (!a.aliasable || !b.aliasable) {
+            return true;
+        }
+        const Resource& first = m_resources[a.resource];
+        const Resource& second = m_resources[b.resource];
+        return first.firstPass <= second.lastPass && second.firstPass <= first.lastPass;
+    };
+
+    std::vector<std::vector<size_t>> placedPerAllocation;
+    for (size_t i = 0; i < placements.size(); i++) {
+        const Placement& placement = placements[i];
+        Resource& resource = m_resources[placement.resource];
+        const uint32_t typeBits = requirements[placement.resource].memoryTypeBits;
+
+        // One allocation per memory type set; in practice every transient image shares one
+        auto allocation = std::find_if(m_allocations.begin(), m_allocations.end(),
+                                       [typeBits](const Allocation& entry) { return entry.memoryTypeBits == typeBits; });
+        if (allocation == m_allocations.end()) {
+            m_allocations.push_back({VK_NULL_HANDLE, 0, typeBits});
+            placedPerAllocation.emplace_back();
+            allocation = m_allocations.end() - 1;
+        }
+        const size_t allocationIndex = static_cast<size_t>(allocation - m_allocations.begin());
+        std::vector<size_t>& placed = placedPerAllocation[allocationIndex];
+
+        std::vector<std::pair<VkDeviceSize, VkDeviceSize>> busy;
+        for (size_t other : placed) {
+            if (livesOverlap(placement, placements[other])) {
+                const Resource& occupant = m_resources[placements[other].resource];
+                busy.emplace_back(occupant.offset, occupant.offset + occupant.size);
+            }
+        }
+        std::sort(busy.begin(), busy.end());
+
+        VkDeviceSize offset = 0;
+        for (const auto& [begin, end] : busy) {
+            if (alignUp(offset, placement.alignment) + resource.size <= begin) {
+                break;
+            }
+            offset = std::max(offset, end);
+        }
+        offset = alignUp(offset, placement.alignment);
+
+        resource.allocation = static_cast<uint32_t>(allocationIndex);
+        resource.offset = offset;
+        allocation->size = std::max(allocation->size, offset + resource.size);
+        placed.push_back(i);
+    }
+
+    // Record which images share memory; their barriers must order against each other
+    for (const std::vector<size_t>& placed : placedPerAllocation) {
+        for (size_t a : placed) {
+            Resource& first = m_resources[placements[a].resource];
+            for (size_t b : placed) {
+                const Resource& second = m_resources[placements[b].resource];
+                if (a != b && first.offset < second.offset + second.size && second.offset < first.offset + first.size) {
+                    first.aliases.push_back(placements[b].resource);
+                }
+            }
+        }
+    }
+
+    for (Allocation& allocation : m_allocations) {
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = allocation.size;
+        allocInfo.memoryTypeIndex = findMemoryType(allocation.memoryTypeBits);
+
+        if (allocInfo.memoryTypeIndex == kNone ||
+            vkAllocateMemory(m_device, &allocInfo, nullptr, &allocation.memory) != VK_SUCCESS) {
+            std::cerr << "Failed to allocate " << allocation.size << " bytes of transient image memory\n";
+            return false;
+        }
+        m_stats.transientBytes += allocation.size;
+    }
+
+    for (uint32_t index : transients) {
+        Resource& resource = m_resources[index];
+        if (vkBindImageMemory(m_device, resource.image, m_allocations[resource.allocation].memory, resource.offset) !=
+            VK_SUCCESS) {
+            std::cerr << "Failed to bind memory for transient image '" << resource.name << "'\n";
+            return false;
+        }
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = resource.image;
+        viewInfo.viewType = resource.desc.arrayLayers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = resource.desc.format;
+        viewInfo.subresourceRange = {getAspectMask(resource.desc.format), 0, resource.desc.mipLevels, 0,
+                                     resource.desc.arrayLayers};
+
+        if (vkCreateImageView(m_device, &viewInfo, nullptr, &resource.view) != VK_SUCCESS) {
+            std::cerr << "Failed to create view for transient image '" << resource.name << "'\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void RenderGraph::buildBatches(const std::vector<uint32_t>& order) {
+    std::array<uint32_t, kQueueCount> sequence{};
+
+    for (uint32_t index : order) {
+        Pass& pass = m_passes[index];
+        if (m_batches.empty() || m_batches.back().queueIndex != pass.queueIndex) {
+            Batch batch;
+            batch.queueIndex = pass.queueIndex;
+            batch.sequence = ++sequence[pass.queueIndex];
+            m_batches.push_back(batch);
+        }
+        m_batches.back().passes.push_back(index);
+        pass.batch = static_cast<uint32_t>(m_batches.size() - 1);
+    }
+}
+
+void RenderGraph::planBarriers(const std::vector<uint32_t>& order) {
+    const bool naive = !m_config.minimalBarriers;
+
+    struct State {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        uint32_t writeQueue = kNone;
+        uint32_t writeBatch = kNone;
+        VkPipelineStageFlags2 writeStages = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 writeAccess = VK_ACCESS_2_NONE;
+        std::array<VkPipelineStageFlags2, kQueueCount> readStages{};   // Reads since the last write
+        std::array<uint32_t, kQueueCount> readBatch{kNone, kNone};
+        VkPipelineStageFlags2 visibleStages = VK_PIPELINE_STAGE_2_NONE; // Where the last write is already visible
+        VkAccessFlags2 visibleAccess = VK_ACCESS_2_NONE;
+        bool sharedLastFrame = false;   // Last frame's uses may be on either queue
+    };
+
+    // Where each resource is left at the end of a frame
+    std::vector<VkPipelineStageFlags2> endStages(m_resources.size(), VK_PIPELINE_STAGE_2_NONE);
+    std::vector<VkAccessFlags2> endAccess(m_resources.size(), VK_ACCESS_2_NONE);
+    for (uint32_t index : order) {
+        for (const RenderPassBuilder::Access& access : m_passes[index].accesses) {
+            const UsageInfo info = getUsageInfo(access.usage);
+            if (access.write) {
+                endStages[access.resource] = info.stages;
+                endAccess[access.resource] = info.writeAccess;
+            } else {
+                endStages[access.resource] |= info.stages;
+            }
+        }
+    }
+
+    std::vector<State> states(m_resources.size());
+    for (uint32_t index = 0; index < m_resources.size(); index++) {
+        const Resource& resource = m_resources[index];
+        State& state = states[index];
+
+        if (resource.firstPass == kNone) {
+            continue;
+        }
+
+        // Imported images start in the state their owner hands over on the graphics queue; compute
+        // passes are ordered after it through the prologue submission in execute()
+        if (resource.imported && resource.isImage) {
+            state.layout = resource.initial.layout;
+            state.writeQueue = kGraphicsQueue;
+            state.writeStages = resource.initial.stages;
+            state.writeAccess = resource.initial.access;
+            continue;
+        }
+
+        // Anything else was last used by this graph in the previous frame, and a transient's
+        // memory also by the images it aliases; the first use must wait for all of them.
+        // Resources shared across queues are ordered by the frame-start semaphore wait instead.
+        state.writeAccess = endAccess[index];
+        if (resource.queueMask == 3u) {
+            state.sharedLastFrame = true;
+            continue;
+        }
+        state.writeQueue = resource.queueMask & 1u ? kGraphicsQueue : kComputeQueue;
+        state.writeStages = endStages[index];
+        for (uint32_t alias : resource.aliases) {
+            state.writeStages |= endStages[alias];
+            state.writeAccess |= endAccess[alias];
+        }
+    }
+
+    const auto waitFor = [this](Batch& batch, uint32_t producer, VkPipelineStageFlags2 stages) {
+        batch.waitSequence = std::max(batch.waitSequence, m_batches[producer].sequence);
+        batch.waitStages |= stages;
+    };
+
+    const auto fullBarrier = [](BarrierBatch& barriers) {
+        VkMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+        barriers.memory.push_back(barrier);
+    };
+
+    for (uint32_t index : order) {
+        Pass& pass = m_passes[index];
+        const uint32_t queue = pass.queueIndex;
+        Batch& batch = m_batches[pass.batch];
+        BarrierBatch& barriers = pass.before;
+
+        VkMemoryBarrier2 bufferBarrier{};
+        bufferBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+
+        if (naive) {
+            fullBarrier(barriers);
+        }
+
+        for (const RenderPassBuilder::Access& access : pass.accesses) {
+            const Resource& resource = m_resources[access.resource];
+            State& state = states[access.resource];
+            const UsageInfo info = getUsageInfo(access.usage);
+            const VkPipelineStageFlags2 stages = info.stages;
+            const VkAccessFlags2 accessMask = access.write ? info.readAccess | info.writeAccess : info.readAccess;
+            const bool layoutChange = resource.isImage && state.layout != info.layout;
+            const bool writes = access.write || layoutChange;
+
+            // Hazards with the other queue: wait for its submission, then chain from the wait stage
+            bool crossQueue = false;
+            if (state.writeBatch != kNone && state.writeQueue != queue) {
+                waitFor(batch, state.writeBatch, stages);
+                crossQueue = true;
+            }
+            if (writes) {
+                for (uint32_t other = 0; other < kQueueCount; other++) {
+                    if (other != queue && state.readBatch[other] != kNone) {
+                        waitFor(batch, state.readBatch[other], stages);
+                        crossQueue = true;
+                    }
+                }
+            }
+
+            // Uses from before the frame on the other queue, or on either queue for shared
+            // resources, are ordered by the frame-start semaphore wait; chain from its stage
+            const bool lastFrame = state.writeBatch == kNone &&
+                                   (state.sharedLastFrame || (state.writeQueue != kNone && state.writeQueue != queue));
+            const VkPipelineStageFlags2 writeStages = lastFrame ? VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT : state.writeStages;
+
+            // Hazards on this queue
+            VkPipelineStageFlags2 srcStages = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2 srcAccess = VK_ACCESS_2_NONE;
+            const bool writtenHere = lastFrame || (state.writeQueue == queue && state.writeStages != VK_PIPELINE_STAGE_2_NONE);
+            bool needed = layoutChange;
+
+            if (writes) {
+                if (writtenHere) {
+                    srcStages |= writeStages;
+                    srcAccess |= state.writeAccess;
+                }
+                srcStages |= state.readStages[queue];
+            } else if (writtenHere && (!lastFrame || state.writeAccess != VK_ACCESS_2_NONE) &&
+                       ((stages & ~state.visibleStages) || (accessMask & ~state.visibleAccess))) {
+                srcStages |= writeStages;
+                srcAccess |= state.writeAccess;
+            }
+            needed = needed || srcStages != VK_PIPELINE_STAGE_2_NONE;
+            if (crossQueue && srcStages == VK_PIPELINE_STAGE_2_NONE) {
+                srcStages = stages;
+            }
+
+            if (naive) {
+                srcStages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+                srcAccess = VK_ACCESS_2_MEMORY_WRITE_BIT;
+            }
+
+            if (resource.isImage && (layoutChange || (needed && !naive))) {
+                VkImageMemoryBarrier2 barrier{};
+                barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+                barrier.srcStageMask = srcStages;
+                barrier.srcAccessMask = srcAccess;
+                barrier.dstStageMask = naive ? VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT : stages;
+                barrier.dstAccessMask = accessMask;
+                barrier.oldLayout = state.layout;
+                barrier.newLayout = info.layout;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.subresourceRange = {getAspectMask(resource.desc.format), 0, VK_REMAINING_MIP_LEVELS, 0,
+                                            VK_REMAINING_ARRAY_LAYERS};
+                barriers.images.push_back(barrier);
+                barriers.imageResources.push_back(access.resource);
+            } else if (!resource.isImage && needed && !naive) {
+                // Buffer hazards fold into one global barrier per pass, cheaper than per-buffer barriers
+                bufferBarrier.srcStageMask |= srcStages;
+                bufferBarrier.srcAccessMask |= srcAccess;
+                bufferBarrier.dstStageMask |= stages;
+                bufferBarrier.dstAccessMask |= accessMask;
+            }
+
+            if (writes) {
+                state.sharedLastFrame = false;
+                state.writeQueue = queue;
+                state.writeBatch = pass.batch;
+                state.writeStages = stages;
+                state.writeAccess = access.write ? info.writeAccess : VK_ACCESS_2_NONE;
+                state.readStages = {};
+                state.readBatch = {kNone, kNone};
+                state.visibleStages = access.write ? VK_PIPELINE_STAGE_2_NONE : stages;
+                state.visibleAccess = access.write ? VK_ACCESS_2_NONE : accessMask;
+            }
+            if (!access.write) {
+                state.readStages[queue] |= stages;
+                state.readBatch[queue] = pass.batch;
+                if (needed || crossQueue) {
+                    state.visibleStages |= stages;
+                    state.visibleAccess |= accessMask;
+                }
+            }
+            if (resource.isImage) {
+                state.layout = info.layout;
+            }
+        }
+
+        if (bufferBarrier.srcStageMask != VK_PIPELINE_STAGE_2_NONE) {
+            barriers.memory.push_back(bufferBarrier);
+        }
+    }
+
+    // Leave imported images in the state their owner expects
+    for (uint32_t index = 0; index < m_resources.size(); index++) {
+        const Resource& resource = m_resources[index];
+        const State& state = states[index];
+        if (!resource.imported || !resource.isImage || resource.lastPass == kNone ||
+            resource.final.layout == VK_IMAGE_LAYOUT_UNDEFINED || resource.final.layout == state.layout) {
+            continue;
+        }
+
+        Pass& last = m_passes[order[resource.lastPass]];
+
+        // Reads on the other queue since the last write must finish before the layout changes;
+        // the barrier chains from the submission wait that covers them
+        const uint32_t other = last.queueIndex == kGraphicsQueue ? kComputeQueue : kGraphicsQueue;
+        VkPipelineStageFlags2 otherReads = VK_PIPELINE_STAGE_2_NONE;
+        if (state.readBatch[other] != kNone) {
+            Batch& batch = m_batches[last.batch];
+            if (batch.waitSequence < m_batches[state.readBatch[other]].sequence) {
+                waitFor(batch, state.readBatch[other], VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+            }
+            otherReads = batch.waitStages;
+        }
+
+        VkImageMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = naive ? VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
+                                     : otherReads | state.readStages[last.queueIndex] |
+                                           (state.writeQueue == last.queueIndex ? state.writeStages : VK_PIPELINE_STAGE_2_NONE);
+        barrier.srcAccessMask = state.writeAccess;
+        barrier.dstStageMask = resource.final.stages;
+        barrier.dstAccessMask = resource.final.access;
+        barrier.oldLayout = state.layout;
+        barrier.newLayout = resource.final.layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.subresourceRange = {getAspectMask(resource.desc.format), 0, VK_REMAINING_MIP_LEVELS, 0,
+                                    VK_REMAINING_ARRAY_LAYERS};
+        last.after.images.push_back(barrier);
+        last.after.imageResources.push_back(index);
+    }
+}
+
+void RenderGraph::collectStats() {
+    m_stats.passes = static_cast<uint32_t>(m_passes.size());
+    m_stats.culledPasses = 0;
+    m_stats.submits = static_cast<uint32_t>(m_batches.size());
+    m_stats.crossQueueWaits = 0;
+    m_stats.barrierBatches = 0;
+    m_stats.imageBarriers = 0;
+    m_stats.bufferBarriers = 0;
+    m_stats.memoryBarriers = 0;
+    m_stats.fullBarriers = 0;
+
+    for (const Batch& batch : m_batches) {
+        m_stats.crossQueueWaits += batch.waitSequence > 0 ? 1 : 0;
+    }
+
+    const auto count = [this](const BarrierBatch& barriers) {
+        if (barriers.empty()) {
+            return;
+        }
+        m_stats.barrierBatches++;
+        m_stats.imageBarriers += static_cast<uint32_t>(barriers.images.size());
+        m_stats.bufferBarriers += static_cast<uint32_t>(barriers.buffers.size());
+        m_stats.memoryBarriers += static_cast<uint32_t>(barriers.memory.size());
+        for (const VkImageMemoryBarrier2& barrier : barriers.images) {
+            m_stats.fullBarriers += barrier.srcStageMask & VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT ? 1 : 0;
+        }
+        for (const VkMemoryBarrier2& barrier : barriers.memory) {
+            m_stats.fullBarriers += barrier.srcStageMask & VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT ? 1 : 0;
+        }
+    };
+
+    for (const Pass& pass : m_passes) {
+        if (!pass.active) {
+            m_stats.culledPasses++;
+            continue;
+        }
+        count(pass.before);
+        count(pass.after);
+    }
+}
+
+bool RenderGraph::execute(const RenderGraphSubmitInfo& submit) {
+    if (!m_compiled) {
+        std::cerr << "Failed to execute render graph: not compiled\n";
+        return false;
+    }
+
+    FrameSlot& frame = m_frames[m_frameIndex];
+    waitForFrame(frame);
+
+    for (VkCommandPool pool : frame.pools) {
+        if (pool != VK_NULL_HANDLE) {
+            vkResetCommandPool(m_device, pool, 0);
+        }
+    }
+
+    uint32_t lastGraphicsBatch = kNone;
+    for (uint32_t i = 0; i < m_batches.size(); i++) {
+        if (m_batches[i].queueIndex == kGraphicsQueue) {
+            lastGraphicsBatch = i;
+        }
+    }
+
+    std::array<uint64_t, kQueueCount> base = m_timelineValues;
+    std::array<uint32_t, kQueueCount> used{};
+    bool firstGraphics = true;
+
+    // Without graphics work the external semaphores and fence still need a submission. Imported
+    // resources are handed over on the graphics queue, so when compute passes use them this
+    // submission also forwards the hand-over (and waitSemaphore) to the graphics timeline
+    const bool noGraphics = lastGraphicsBatch == kNone && (submit.waitSemaphore != VK_NULL_HANDLE ||
+                                                           submit.signalSemaphore != VK_NULL_HANDLE ||
+                                                           (m_batches.empty() && submit.fence != VK_NULL_HANDLE));
+    if (noGraphics || m_importsOnCompute) {
+        VkSemaphoreSubmitInfo wait{};
+        wait.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        wait.semaphore = submit.waitSemaphore;
+        wait.stageMask = m_importsOnCompute ? VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT : submit.waitStages;
+
+        std::array<VkSemaphoreSubmitInfo, 2> signals{};
+        uint32_t signalCount = 0;
+        if (m_importsOnCompute) {
+            base[kGraphicsQueue]++;
+            VkSemaphoreSubmitInfo& signal = signals[signalCount++];
+            signal.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            signal.semaphore = m_timelines[kGraphicsQueue];
+            signal.value = base[kGraphicsQueue];
+            signal.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        }
+        if (lastGraphicsBatch == kNone && submit.signalSemaphore != VK_NULL_HANDLE) {
+            VkSemaphoreSubmitInfo& signal = signals[signalCount++];
+            signal.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            signal.semaphore = submit.signalSemaphore;
+            signal.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        }
+
+        VkSubmitInfo2 info{};
+        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+        info.waitSemaphoreInfoCount = submit.waitSemaphore != VK_NULL_HANDLE ? 1 : 0;
+        info.pWaitSemaphoreInfos = &wait;
+        info.signalSemaphoreInfoCount = signalCount;
+        info.pSignalSemaphoreInfos = signals.data();
+        if (vkQueueSubmit2(m_queues[kGraphicsQueue], 1, &info, m_batches.empty() ? submit.fence : VK_NULL_HANDLE) !=
+            VK_SUCCESS) {
+            std::cerr << "Failed to submit render graph frame\n";
+            return false;
+        }
+        firstGraphics = false;
+    }
+
+    for (uint32_t i = 0; i < m_batches.size(); i++) {
+        const Batch& batch = m_batches[i];
+        const uint32_t queue = batch.queueIndex;
+        const uint32_t other = queue == kGraphicsQueue ? kComputeQueue : kGraphicsQueue;
+        const VkCommandBuffer commandBuffer = frame.commandBuffers[queue][used[queue]++];
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+        for (uint32_t index : batch.passes) {
+            Pass& pass = m_passes[index];
+            recordBarriers(commandBuffer, pass.before);
+            if (pass.execute) {
+                pass.execute(commandBuffer, *this);
+            }
+            recordBarriers(commandBuffer, pass.after);
+        }
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+            std::cerr << "Failed to record render graph commands\n";
+            return false;
+        }
+
+        std::array<VkSemaphoreSubmitInfo, 2> waits{};
+        uint32_t waitCount = 0;
+        const auto addWait = [&](VkSemaphore semaphore, uint64_t value, VkPipelineStageFlags2 stages) {
+            VkSemaphoreSubmitInfo& wait = waits[waitCount++];
+            wait.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            wait.semaphore = semaphore;
+            wait.value = value;
+            wait.stageMask = stages;
+        };
+
+        if (batch.waitSequence > 0) {
+            addWait(m_timelines[other], base[other] + batch.waitSequence, batch.waitStages);
+        } else if (used[queue] == 1 && base[other] > 0 &&
+                   (m_sharedAcrossQueues || (queue == kComputeQueue && m_importsOnCompute))) {
+            // Resources shared across queues were last touched by the other queue in the previous
+            // frame; imported ones were handed over on the graphics queue
+            addWait(m_timelines[other], base[other], VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+        }
+        if (queue == kGraphicsQueue && firstGraphics && submit.waitSemaphore != VK_NULL_HANDLE) {
+            addWait(submit.waitSemaphore, 0, submit.waitStages);
+        }
+
+        std::array<VkSemaphoreSubmitInfo, 2> signals{};
+        uint32_t signalCount = 1;
+        signals[0].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        signals[0].semaphore = m_timelines[queue];
+        signals[0].value = base[queue] + batch.sequence;
+        signals[0].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        if (i == lastGraphicsBatch && submit.signalSemaphore != VK_NULL_HANDLE) {
+            signals[1].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            signals[1].semaphore = submit.signalSemaphore;
+            signals[1].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            signalCount = 2;
+        }
+
+        VkCommandBufferSubmitInfo commandInfo{};
+        commandInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+        commandInfo.commandBuffer = commandBuffer;
+
+        VkSubmitInfo2 info{};
+        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+        info.waitSemaphoreInfoCount = waitCount;
+        info.pWaitSemaphoreInfos = waits.data();
+        info.commandBufferInfoCount = 1;
+        info.pCommandBufferInfos = &commandInfo;
+        info.signalSemaphoreInfoCount = signalCount;
+        info.pSignalSemaphoreInfos = signals.data();
+
+        const VkFence fence = i + 1 == m_batches.size() ? submit.fence : VK_NULL_HANDLE;
+        if (vkQueueSubmit2(m_queues[queue], 1, &info, fence) != VK_SUCCESS) {
+            std::cerr << "Failed to submit render graph frame\n";
+            return false;
+        }
+
+        if (queue == kGraphicsQueue) {
+            firstGraphics = false;
+        }
+    }
+
+    for (uint32_t queue = 0; queue < kQueueCount; queue++) {
+        m_timelineValues[queue] = base[queue] + used[queue];
+    }
+    frame.timelineValues = m_timelineValues;
+    m_frameIndex = (m_frameIndex + 1) % static_cast<uint32_t>(m_frames.size());
+    return true;
+}
+
+bool RenderGraph::isPassActive(const std::string& name) const {
+    for (const Pass& pass : m_passes) {
+        if (pass.name == name) {
+            return pass.active;
+        }
+    }
+    return false;
+}
+
+void RenderGraph::printStats() const {
+    constexpr double kMiB = 1024.0 * 1024.0;
+    std::cout << std::fixed << std::setprecision(1) << "Render graph: " << m_stats.passes << " passes ("
+              << m_stats.culledPasses << " culled), " << m_stats.submits << " submits (" << m_stats.crossQueueWaits
+              << " cross-queue waits), " << m_stats.imageBarriers + m_stats.bufferBarriers + m_stats.memoryBarriers
+              << " barriers in " << m_stats.barrierBatches << " batches (" << m_stats.fullBarriers
+              << " full), transient memory " << static_cast<double>(m_stats.transientBytes) / kMiB << " MiB ("
+              << static_cast<double>(m_stats.unaliasedTransientBytes) / kMiB << " MiB unaliased)\n"
+              << std::defaultfloat;
+}
+
+void RenderGraph::waitForFrame(const FrameSlot& frame) const {
+    std::array<VkSemaphore, kQueueCount> semaphores{};
+    std::array<uint64_t, kQueueCount> values{};
+    uint32_t count = 0;
+
+    for (uint32_t queue = 0; queue < kQueueCount; queue++) {
+        if (m_timelines[queue] != VK_NULL_HANDLE && frame.timelineValues[queue] > 0) {
+            semaphores[count] = m_timelines[queue];
+            values[count] = frame.timelineValues[queue];
+            count++;
+        }
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = count;
+    waitInfo.pSemaphores = semaphores.data();
+    waitInfo.pValues = values.data();
+    vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX);
+}
+
+uint32_t RenderGraph::findMemoryType(uint32_t typeBits) const {
+    VkPhysicalDeviceMemoryProperties properties;
+    vkGetPhysicalDeviceMemoryProperties(m_context->getPhysicalDevice(), &properties);
+
+    // Prefer device-local memory, fall back to any allowed type
+    for (uint32_t type = 0; type < properties.memoryTypeCount; type++) {
+        if ((typeBits & (1u << type)) &&
+            (properties.memoryTypes[type].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+            return type;
+        }
+    }
+    for (uint32_t type = 0; type < properties.memoryTypeCount; type++) {
+        if (typeBits & (1u << type)) {
+            return type;
+        }
+    }
+    return kNone;
+}
+
+void RenderGraph::releaseCompiled() {
+    if (m_device == VK_NULL_HANDLE) {
+        return;
+    }
+
+    // Transient images and command buffers may still be in use by earlier frames
+    for (const FrameSlot& frame : m_frames) {
+        waitForFrame(frame);
+    }
+
+    for (FrameSlot& frame : m_frames) {
+        for (uint32_t queue = 0; queue < kQueueCount; queue++) {
+            if (!frame.commandBuffers[queue].empty()) {
+                vkFreeCommandBuffers(m_device, frame.pools[queue],
+                                     static_cast<uint32_t>(frame.commandBuffers[queue].size()),
+                                     frame.commandBuffers[queue].data());
+                frame.commandBuffers[queue].clear();
+            }
+        }
+    }
+
+    for (Resource& resource : m_resources) {
+        if (!resource.imported) {
+            if (resource.view != VK_NULL_HANDLE) {
+                vkDestroyImageView(m_device, resource.view, nullptr);
+            }
+            if (resource.image != VK_NULL_HANDLE) {
+                vkDestroyImage(m_device, resource.image, nullptr);
+            }
+            resource.view = VK_NULL_HANDLE;
+            resource.image = VK_NULL_HANDLE;
+        }
+        resource.usage = 0;
+        resource.firstPass = kNone;
+        resource.lastPass = kNone;
+        resource.queueMask = 0;
+        resource.allocation = kNone;
+        resource.offset = 0;
+        resource.size = 0;
+        resource.aliases.clear();
+    }
+
+    for (Allocation& allocation : m_allocations) {
+        if (allocation.memory != VK_NULL_HANDLE) {
+            vkFreeMemory(m_device, allocation.memory, nullptr);
+        }
+    }
+    m_allocations.clear();
+
+    for (Pass& pass : m_passes) {
+        pass.active = false;
+        pass.batch = kNone;
+        pass.before.clear();
+        pass.after.clear();
+    }
+
+    m_batches.clear();
+    m_sharedAcrossQueues = false;
+    m_importsOnCompute = false;
+    m_stats = {};
+    m_compiled = false;
+}
+
+void RenderGraph::recordBarriers(VkCommandBuffer commandBuffer, BarrierBatch& barriers) const {
+    if (barriers.empty()) {
+        return;
+    }
+
+    for (size_t i = 0; i < barriers.images.size(); i++) {
+        barriers.images[i].image = m_resources[barriers.imageResources[i]].image;
+    }
+    for (size_t i = 0; i < barriers.buffers.size(); i++) {
+        barriers.buffers[i].buffer = m_resources[barriers.bufferResources[i]].buffer;
+    }
+
+    VkDependencyInfo dependency{};
+    dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency.memoryBarrierCount = static_cast<uint32_t>(barriers.memory.size());
+    dependency.pMemoryBarriers = barriers.memory.data();
+    dependency.bufferMemoryBarrierCount = static_cast<uint32_t>(barriers.buffers.size());
+    dependency.pBufferMemoryBarriers = barriers.buffers.data();
+    dependency.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.images.size());
+    dependency.pImageMemoryBarriers = barriers.images.data();
+    vkCmdPipelineBarrier2(commandBuffer, &dependency);
+}
+
+} // namespace ct
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace ct {
+
+class RenderGraph;
+class VulkanContext;
+
+/// Handle to an image or buffer in a render graph
+struct RenderResource {
+    static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    uint32_t index = kInvalidIndex;
+
+    [[nodiscard]] bool isValid() const { return index != kInvalidIndex; }
+};
+
+/// How a pass touches a resource; determines pipeline stages, access flags and image layout
+enum class ResourceUsage : uint8_t {
+    ColorAttachment,
+    DepthAttachment,
+    DepthRead,              // Depth test without writes
+    SampledFragment,
+    SampledCompute,
+    StorageCompute,         // Storage image or buffer in a compute shader
+    TransferSource,
+    TransferDestination,
+    VertexBuffer,
+    IndexBuffer,
+    UniformBuffer,
+    IndirectBuffer,
+};
+
+/// Queue a pass is submitted to
+enum class PassQueue : uint8_t {
+    Graphics,
+    AsyncCompute,           // Dedicated compute queue when present, graphics otherwise
+};
+
+/// Image created or imported by the graph
+struct RenderImageDesc {
+    VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevels = 1;
+    uint32_t arrayLayers = 1;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+};
+
+/// Synchronization state of an imported resource at the edge of the graph
+/// The initial state describes graphics-queue work submitted before execute(), or work
+/// ordered by RenderGraphSubmitInfo::waitSemaphore.
+struct ImportedResourceState {
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;   // UNDEFINED as a final state = leave as last used
+    VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    VkAccessFlags2 access = VK_ACCESS_2_NONE;
+};
+
+/// Configuration for the render graph
+/// Turning every optimization off gives the naive baseline: a full barrier before each pass,
+/// one allocation per transient image, no culling and a single queue.
+struct RenderGraphConfig {
+    uint32_t framesInFlight = 2;        // Command buffers are recycled after this many frames
+    bool cullPasses = true;             // Drop passes whose results nothing reads
+    bool aliasTransients = true;        // Share memory between transient images with disjoint lifetimes
+    bool minimalBarriers = true;        // Per-resource barriers (false = ALL_COMMANDS barrier per pass)
+    bool asyncCompute = true;           // Use the dedicated compute queue when the device has one
+};
+
+/// Result of the last compile()
+struct RenderGraphStats {
+    uint32_t passes = 0;
+    uint32_t culledPasses = 0;
+    uint32_t submits = 0;               // Queue submissions per frame
+    uint32_t crossQueueWaits = 0;
+    uint32_t barrierBatches = 0;        // vkCmdPipelineBarrier2 calls per frame
+    uint32_t imageBarriers = 0;
+    uint32_t bufferBarriers = 0;
+    uint32_t memoryBarriers = 0;
+    uint32_t fullBarriers = 0;          // Barriers waiting on ALL_COMMANDS (pipeline drains)
+    VkDeviceSize transientBytes = 0;    // Memory allocated for transient images
+    VkDeviceSize unaliasedTransientBytes = 0;
+};
+
+/// Binary semaphores and fence for one RenderGraph::execute()
+struct RenderGraphSubmitInfo {
+    VkSemaphore waitSemaphore = VK_NULL_HANDLE;     // Waited by the first graphics submission (e.g. image acquired)
+    VkPipelineStageFlags2 waitStages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+    VkSemaphore signalSemaphore = VK_NULL_HANDLE;   // Signaled by the last graphics submission (e.g. render finished)
+    VkFence fence = VK_NULL_HANDLE;                 // Signaled by the last submission
+};
+
+/// Declares the resources a pass reads and writes
+class RenderPassBuilder {
+public:
+    /// Declare a read; the pass sees every earlier write
+    void read(RenderResource resource, ResourceUsage usage);
+
+    /// Declare a write (attachment and storage writes also load the previous contents)
+    void write(RenderResource resource, ResourceUsage usage);
+
+    /// Keep the pass even if nothing reads its results (e.g. readbacks, queries)
+    void setSideEffects() { m_sideEffects = true; }
+
+private:
+    friend class RenderGraph;
+
+    struct Access {
+        uint32_t resource = RenderResource::kInvalidIndex;
+        ResourceUsage usage = ResourceUsage::SampledFragment;
+        bool write = false;
+    };
+
+    void add(RenderResource resource, ResourceUsage usage, bool write);
+
+    std::vector<Access> m_accesses;
+    bool m_sideEffects = false;
+};
+
+/// Frame graph on top of VulkanContext
+///
+/// Build once: create or import resources and add passes with the resources they touch, then
+/// compile(). Compilation culls passes that do not contribute to an output, places transient
+/// images in shared memory by lifetime, and plans the barriers: each resource is tracked through
+/// the pass list so a barrier is only emitted for a real hazard or layout change, with the exact
+/// stages and access involved, and all barriers before a pass go out in one vkCmdPipelineBarrier2.
+/// Consecutive passes on the same queue share a command buffer and submission; passes on the
+/// async compute queue are ordered against graphics with timeline semaphores.
+///
+/// execute() then records and submits the frame. Imported images (e.g. the swapchain image) may be
+/// swapped between frames with setImportedImage() without recompiling.
+class RenderGraph {
+public:
+    /// Records a pass's commands
+    using PassExecute = std::function<void(VkCommandBuffer commandBuffer, const RenderGraph& graph)>;
+
+    RenderGraph() = default;
+    ~RenderGraph();
+
+    // Non-copyable
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    /// Create command pools and timeline semaphores
+    /// @param context Initialized Vulkan context (must outlive the graph)
+    /// @param config Render graph configuration settings
+    /// @return true if initialization succeeded
+    bool initialize(const VulkanContext& context, const RenderGraphConfig& config = {});
+
+    /// Wait for in-flight frames and release all resources
+    void shutdown();
+
+    /// Drop all passes and resources so the graph can be rebuilt (e.g. after a resize)
+    void reset();
+
+    /// Declare an image owned by the graph, valid only during the frame
+    RenderResource createImage(const std::string& name, const RenderImageDesc& desc);
+
+    /// Declare an image owned by the caller
+    /// @param initial State the image is in before the graph runs
+    /// @param final State to leave it in (e.g. PRESENT_SRC_KHR for a swapchain image)
+    /// @param concurrent Whether the image was created VK_SHARING_MODE_CONCURRENT for the graphics
+    ///                   and compute families; compile() fails if passes on both queues use an
+    ///                   exclusive image and the families differ
+    RenderResource importImage(const std::string& name, const RenderImageDesc& desc, VkImage image,
+                               VkImageView view, const ImportedResourceState& initial = {},
+                               const ImportedResourceState& final = {}, bool concurrent = false);
+
+    /// Declare a buffer owned by the caller
+    /// Its first use in a frame waits for the graph's own uses in the previous frame; other
+    /// writers must synchronize with the graph themselves.
+    /// @param concurrent As for importImage()
+    RenderResource importBuffer(const std::string& name, VkBuffer buffer, VkDeviceSize size, bool concurrent = false);
+
+    /// Replace the image behind an imported resource (same description)
+    void setImportedImage(RenderResource resource, VkImage image, VkImageView view);
+
+    /// Replace the buffer behind an imported resource
+    void setImportedBuffer(RenderResource resource, VkBuffer buffer);
+
+    /// Keep the passes producing this resource even if no pass reads it
+    /// Writes to imported resources are always kept.
+    void markOutput(RenderResource resource);
+
+    /// Add a pass
+    /// @param setup Declares the pass's reads and writes
+    /// @param execute Records the pass's commands
+    void addPass(const std::string& name, PassQueue queue, const std::function<void(RenderPassBuilder&)>& setup,
+                 PassExecute execute);
+
+    /// Cull, allocate transient memory and plan barriers and submissions
+    /// @return true if compilation succeeded
+    bool compile();
+
+    /// Record and submit one frame
+    /// @return true if every submission succeeded
+    bool execute(const RenderGraphSubmitInfo& submit = {});
+
+    // Accessors for pass callbacks
+    [[nodiscard]] VkImage getImage(RenderResource resource) const { return m_resources[resource.index].image; }
+    [[nodiscard]] VkImageView getImageView(RenderResource resource) const { return m_resources[resource.index].view; }
+    [[nodiscard]] VkBuffer getBuffer(RenderResource resource) const { return m_resources[resource.index].buffer; }
+    [[nodiscard]] const RenderImageDesc& getImageDesc(RenderResource resource) const { return m_resources[resource.index].desc; }
+
+    /// Check whether a pass survived culling in the last compile()
+    [[nodiscard]] bool isPassActive(const std::string& name) const;
+
+    [[nodiscard]] const RenderGraphStats& getStats() const { return m_stats; }
+
+    /// Print a one-line summary of getStats()
+    void printStats() const;
+
+private:
+    static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t kQueueCount = 2;
+
+    struct Resource {
+        std::string name;
+        bool isImage = true;
+        bool imported = false;
+        bool concurrent = false;            // Imported with VK_SHARING_MODE_CONCURRENT
+        bool output = false;
+        RenderImageDesc desc;
+        VkDeviceSize bufferSize = 0;
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        ImportedResourceState initial;
+        ImportedResourceState final;
+
+        // Filled by compile()
+        VkImageUsageFlags usage = 0;
+        uint32_t firstPass = kNone;         // Positions in the live pass order
+        uint32_t lastPass = kNone;
+        uint32_t queueMask = 0;             // Bit per queue that touches the resource
+        uint32_t allocation = kNone;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        std::vector<uint32_t> aliases;      // Transients sharing memory with this one
+    };
+
+    struct BarrierBatch {
+        std::vector<VkImageMemoryBarrier2> images;
+        std::vector<uint32_t> imageResources;   // Patched into images[i].image at execute time
+        std::vector<VkBufferMemoryBarrier2> buffers;
+        std::vector<uint32_t> bufferResources;
+        std::vector<VkMemoryBarrier2> memory;
+
+        [[nodiscard]] bool empty() const { return images.empty() && buffers.empty() && memory.empty(); }
+        void clear();
+    };
+
+    struct Pass {
+        std::string name;
+        PassQueue queue = PassQueue::Graphics;
+        std::vector<RenderPassBuilder::Access> accesses;
+        PassExecute execute;
+        bool sideEffects = false;
+
+        // Filled by compile()
+        bool active = false;
+        uint32_t queueIndex = 0;
+        uint32_t batch = kNone;
+        BarrierBatch before;
+        BarrierBatch after;                 // Final transitions of imported resources
+    };
+
+    struct Batch {
+        uint32_t queueIndex = 0;
+        std::vector<uint32_t> passes;
+        uint32_t sequence = 0;              // 1-based position among this queue's batches
+        uint32_t waitSequence = 0;          // Batch on the other queue to wait for (0 = none)
+        VkPipelineStageFlags2 waitStages = VK_PIPELINE_STAGE_2_NONE;
+    };
+
+    struct Allocation {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+        uint32_t memoryTypeBits = 0;
+    };
+
+    struct FrameSlot {
+        std::array<VkCommandPool, kQueueCount> pools{};
+        std::array<std::vector<VkCommandBuffer>, kQueueCount> commandBuffers;
+        std::array<uint64_t, kQueueCount> timelineValues{};     // Last value signaled by this slot
+    };
+
+    /// Mark passes reachable from outputs and side effects
+    void cullPasses(const std::vector<uint32_t>& order);
+
+    /// Create transient images and place them in shared memory
+    bool allocateTransients();
+
+    /// Group consecutive passes on the same queue into submissions
+    void buildBatches(const std::vector<uint32_t>& order);
+
+    /// Track every resource through the pass order and place barriers and cross-queue waits
+    void planBarriers(const std::vector<uint32_t>& order);
+
+    /// Count barriers and submissions
+    void collectStats();
+
+    /// Block until a frame slot's previous submissions have finished
+    void waitForFrame(const FrameSlot& frame) const;
+
+    /// Find a device-local memory type
+    uint32_t findMemoryType(uint32_t typeBits) const;
+
+    /// Release transient images, memory and command buffers
+    void releaseCompiled();
+
+    /// Patch resource handles into a barrier batch and record it
+    void recordBarriers(VkCommandBuffer commandBuffer, BarrierBatch& barriers) const;
+
+    const VulkanContext* m_context = nullptr;
+    VkDevice m_device = VK_NULL_HANDLE;
+    RenderGraphConfig m_config;
+    bool m_initialized = false;
+    bool m_compiled = false;
+
+    std::array<VkQueue, kQueueCount> m_queues{};
+    std::array<uint32_t, kQueueCount> m_queueFamilies{};
+    std::array<VkSemaphore, kQueueCount> m_timelines{};
+    std::array<uint64_t, kQueueCount> m_timelineValues{};
+    bool m_hasComputeQueue = false;
+    bool m_sharedAcrossQueues = false;  // Some resource is used on both queues
+    bool m_importsOnCompute = false;    // Some imported resource is used on the compute queue
+
+    std::vector<Resource> m_resources;
+    std::vector<Pass> m_passes;
+    std::vector<Batch> m_batches;
+    std::vector<Allocation> m_allocations;
+    std::vector<FrameSlot> m_frames;
+    uint32_t m_frameIndex = 0;
+    RenderGraphStats m_stats;
+};
+
+} // namespace ct
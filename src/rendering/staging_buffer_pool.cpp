@@ -0,0 +1,89 @@
+#include "rendering/staging_buffer_pool.h"
+
+#include <iostream>
+
+namespace ct {
+
+StagingBufferPool::~StagingBufferPool() {
+    shutdown();
+}
+
+bool StagingBufferPool::initialize(size_t slotBytes, uint32_t slotCount, void* mappedMemory) {
+    if (slotBytes == 0 || slotCount == 0) {
+        std::cerr << "Staging buffer pool needs at least one non-empty slot\n";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (mappedMemory) {
+        m_ownedMemory.reset();
+        m_memory = static_cast<uint8_t*>(mappedMemory);
+    } else {
+        m_ownedMemory = std::make_unique<uint8_t[]>(slotBytes * slotCount);
+        m_memory = m_ownedMemory.get();
+    }
+
+    m_slotBytes = slotBytes;
+    m_slotCount = slotCount;
+
+    // Reverse order so slot 0 is handed out first
+    m_freeSlots.clear();
+    for (uint32_t slot = slotCount; slot > 0; slot--) {
+        m_freeSlots.push_back(slot - 1);
+    }
+
+    m_shutdown = false;
+    return true;
+}
+
+void StagingBufferPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_shutdown) {
+            return;
+        }
+        // Memory stays valid until destruction or re-initialization: producers
+        // may still be writing into slots they already hold
+        m_shutdown = true;
+        m_freeSlots.clear();
+    }
+    m_slotReleased.notify_all();
+}
+
+uint32_t StagingBufferPool::acquire() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_slotReleased.wait(lock, [this] { return m_shutdown || !m_freeSlots.empty(); });
+
+    if (m_shutdown) {
+        return kInvalidSlot;
+    }
+
+    const uint32_t slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    return slot;
+}
+
+uint32_t StagingBufferPool::tryAcquire() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_shutdown || m_freeSlots.empty()) {
+        return kInvalidSlot;
+    }
+
+    const uint32_t slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    return slot;
+}
+
+void StagingBufferPool::release(uint32_t slot) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_shutdown || slot >= m_slotCount) {
+            return;
+        }
+        m_freeSlots.push_back(slot);
+    }
+    m_slotReleased.notify_one();
+}
+
+} // namespace ct
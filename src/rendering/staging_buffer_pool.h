@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ct {
+
+/// Fixed-size slots carved out of one upload buffer
+/// Producers decode straight into a slot; the renderer copies the slot to the GPU and releases it.
+/// The backing memory is either a persistently mapped VkBuffer or, until one exists, host memory.
+class StagingBufferPool {
+public:
+    static constexpr uint32_t kInvalidSlot = std::numeric_limits<uint32_t>::max();
+
+    StagingBufferPool() = default;
+    ~StagingBufferPool();
+
+    // Non-copyable
+    StagingBufferPool(const StagingBufferPool&) = delete;
+    StagingBufferPool& operator=(const StagingBufferPool&) = delete;
+
+    /// Carve the slots
+    /// @param slotBytes Size of each slot
+    /// @param slotCount Number of slots
+    /// @param mappedMemory Mapped buffer of at least slotBytes * slotCount bytes (nullptr = allocate host memory)
+    /// @return true if initialization succeeded
+    bool initialize(size_t slotBytes, uint32_t slotCount, void* mappedMemory = nullptr);
+
+    /// Stop handing out slots and wake any blocked acquire() calls
+    void shutdown();
+
+    /// Take a free slot, blocking until one is released
+    /// @return Slot index, or kInvalidSlot if the pool was shut down
+    uint32_t acquire();
+
+    /// Take a free slot without blocking
+    /// @return Slot index, or kInvalidSlot if none is free
+    uint32_t tryAcquire();
+
+    /// Return a slot to the pool
+    void release(uint32_t slot);
+
+    /// Get the CPU address of a slot
+    [[nodiscard]] void* getSlotData(uint32_t slot) const { return m_memory + slot * m_slotBytes; }
+
+    /// Get the byte offset of a slot within the buffer (for vkCmdCopyBufferToImage)
+    [[nodiscard]] size_t getSlotOffset(uint32_t slot) const { return slot * m_slotBytes; }
+
+    [[nodiscard]] size_t getSlotBytes() const { return m_slotBytes; }
+    [[nodiscard]] uint32_t getSlotCount() const { return m_slotCount; }
+
+private:
+    std::unique_ptr<uint8_t[]> m_ownedMemory;
+    uint8_t* m_memory = nullptr;
+    size_t m_slotBytes = 0;
+    uint32_t m_slotCount = 0;
+
+    std::vector<uint32_t> m_freeSlots;
+    std::mutex m_mutex;
+    std::condition_variable m_slotReleased;
+    bool m_shutdown = true;
+};
+
+} // namespace ct
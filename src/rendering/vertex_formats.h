@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ct {
+
+/// Compact GPU vertex produced by the mesh processor (20 bytes)
+/// Layout must match the inputs of shaders/quantized.vert
+struct QuantizedVertex {
+    uint16_t position[4];   // UNORM16 within the mesh bounds (w is padding)
+    int16_t normal[2];      // Octahedral-encoded unit normal, SNORM16
+    uint16_t uv[2];         // UNORM16 within the mesh UV bounds
+    uint8_t color[4];       // UNORM8 RGBA
+};
+
+static_assert(sizeof(QuantizedVertex) == 20, "QuantizedVertex layout must stay tightly packed");
+
+/// Per-mesh dequantization constants, pushed after the MVP matrix
+/// Layout must match the push constant block of shaders/quantized.vert
+struct QuantizationParams {
+    glm::vec4 positionOffset{0.0f};     // xyz: mesh bounds minimum
+    glm::vec4 positionScale{1.0f};      // xyz: mesh bounds extent
+    glm::vec4 uvOffsetScale{0.0f, 0.0f, 1.0f, 1.0f}; // xy: UV minimum, zw: UV extent
+};
+
+static_assert(sizeof(QuantizationParams) + 64 <= 128, "Push constants must fit the guaranteed 128 bytes");
+
+/// Get the vertex buffer binding for QuantizedVertex
+inline VkVertexInputBindingDescription getQuantizedVertexBindingDescription() {
+    VkVertexInputBindingDescription binding{};
+    binding.binding = 0;
+    binding.stride = sizeof(QuantizedVertex);
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    return binding;
+}
+
+/// Get the vertex attributes for QuantizedVertex
+/// All formats are in Vulkan's mandatory vertex buffer format set
+inline std::array<VkVertexInputAttributeDescription, 4> getQuantizedVertexAttributeDescriptions() {
+    std::array<VkVertexInputAttributeDescription, 4> attributes{};
+
+    attributes[0].location = 0;
+    attributes[0].binding = 0;
+    attributes[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+    attributes[0].offset = offsetof(QuantizedVertex, position);
+
+    attributes[1].location = 1;
+    attributes[1].binding = 0;
+    attributes[1].format = VK_FORMAT_R16G16_SNORM;
+    attributes[1].offset = offsetof(QuantizedVertex, normal);
+
+    attributes[2].location = 2;
+    attributes[2].binding = 0;
+    attributes[2].format = VK_FORMAT_R16G16_UNORM;
+    attributes[2].offset = offsetof(QuantizedVertex, uv);
+
+    attributes[3].location = 3;
+    attributes[3].binding = 0;
+    attributes[3].format = VK_FORMAT_R8G8B8A8_UNORM;
+    attributes[3].offset = offsetof(QuantizedVertex, color);
+
+    return attributes;
+}
+
+} // namespace ct
@@ -1,9 +1,11 @@
 #include "rendering/vulkan_context.h"
+#include "asset_pipeline/asset_importer.h"
 #include "core/window.h"
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
+#include <fstream>
 #include <iostream>
 #include <set>
 #include <cstring>
@@ -17,10 +19,24 @@ VulkanContext::~VulkanContext() {
 bool VulkanContext::initialize(const VulkanContextConfig& config, Window& window) {
     std::cout << "Initializing Vulkan context...\n";
 
+    if (!initializeInstance(config)) {
+        return false;
+    }
+
+    if (!initializeDevice(config, window, readPipelineCache(config.pipelineCachePath))) {
+        return false;
+    }
+
+    std::cout << "Vulkan context initialized successfully.\n";
+    return true;
+}
+
+bool VulkanContext::initializeInstance(const VulkanContextConfig& config) {
     m_validationEnabled = config.enableValidation;
+    m_headless = false;
 
     // Create instance
-    if (!createInstance(config, window)) {
+    if (!createInstance(config)) {
         return false;
     }
 
@@ -32,13 +48,21 @@ bool VulkanContext::initialize(const VulkanContextConfig& config, Window& window
         }
     }
 
+    // Enumeration loads the ICDs, which is slow on some drivers; do it before the window is needed
+    return enumeratePhysicalDevices();
+}
+
+bool VulkanContext::initializeDevice(const VulkanContextConfig& config, Window& window,
+                                     const std::vector<uint8_t>& pipelineCacheData) {
+    m_pipelineCachePath = config.pipelineCachePath;
+
     // Create surface for rendering
     if (!createSurface(window)) {
         return false;
     }
 
     // Pick physical device (GPU)
-    if (!pickPhysicalDevice()) {
+    if (!pickPhysicalDevice(config.preferredDevice)) {
         return false;
     }
 
@@ -47,11 +71,42 @@ bool VulkanContext::initialize(const VulkanContextConfig& config, Window& window
         return false;
     }
 
-    std::cout << "Vulkan context initialized successfully.\n";
+    return createPipelineCache(pipelineCacheData);
+}
+
+bool VulkanContext::initializeHeadless(const VulkanContextConfig& config) {
+    std::cout << "Initializing headless Vulkan context...\n";
+
+    m_validationEnabled = config.enableValidation;
+    m_headless = true;
+    m_pipelineCachePath = config.pipelineCachePath;
+
+    if (!createInstance(config)) {
+        return false;
+    }
+
+    if (m_validationEnabled && !setupDebugMessenger()) {
+        std::cerr << "Warning: Failed to setup debug messenger\n";
+    }
+
+    if (!enumeratePhysicalDevices() || !pickPhysicalDevice(config.preferredDevice) || !createLogicalDevice() ||
+        !createPipelineCache(readPipelineCache(config.pipelineCachePath))) {
+        return false;
+    }
+
+    std::cout << "Headless Vulkan context initialized successfully.\n";
     return true;
 }
 
 void VulkanContext::shutdown() {
+    if (m_pipelineCache != VK_NULL_HANDLE) {
+        if (!m_pipelineCachePath.empty()) {
+            savePipelineCache();
+        }
+        vkDestroyPipelineCache(m_device, m_pipelineCache, nullptr);
+        m_pipelineCache = VK_NULL_HANDLE;
+    }
+
     if (m_device != VK_NULL_HANDLE) {
         vkDestroyDevice(m_device, nullptr);
         m_device = VK_NULL_HANDLE;
@@ -73,8 +128,13 @@ void VulkanContext::shutdown() {
     }
 
     m_physicalDevice = VK_NULL_HANDLE;
+    m_physicalDevices.clear();
+    m_pipelineCachePath.clear();
     m_graphicsQueue = VK_NULL_HANDLE;
     m_presentQueue = VK_NULL_HANDLE;
+    m_computeQueue = VK_NULL_HANDLE;
+    m_presentWaitEnabled = false;
+    m_headless = false;
 }
 
 void VulkanContext::waitIdle() {
@@ -83,7 +143,39 @@ void VulkanContext::waitIdle() {
     }
 }
 
-bool VulkanContext::createInstance(const VulkanContextConfig& config, Window& window) {
+std::vector<uint8_t> VulkanContext::readPipelineCache(const std::filesystem::path& path) {
+    if (path.empty()) {
+        return {};
+    }
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return {};
+    }
+
+    std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+        std::cerr << "Warning: Failed to read pipeline cache: " << path << "\n";
+        return {};
+    }
+    return data;
+}
+
+std::vector<VkPresentModeKHR> VulkanContext::getSurfacePresentModes() const {
+    if (m_physicalDevice == VK_NULL_HANDLE || m_surface == VK_NULL_HANDLE) {
+        return {};
+    }
+
+    uint32_t modeCount = 0;
+    vkGetPhysicalDeviceSurfacePresentModesKHR(m_physicalDevice, m_surface, &modeCount, nullptr);
+
+    std::vector<VkPresentModeKHR> modes(modeCount);
+    vkGetPhysicalDeviceSurfacePresentModesKHR(m_physicalDevice, m_surface, &modeCount, modes.data());
+    return modes;
+}
+
+bool VulkanContext::createInstance(const VulkanContextConfig& config) {
     // Check validation layer support
     if (m_validationEnabled && !checkValidationLayerSupport()) {
         std::cerr << "Validation layers requested but not available!\n";
@@ -100,7 +192,7 @@ bool VulkanContext::createInstance(const VulkanContextConfig& config, Window& wi
     appInfo.apiVersion = VK_API_VERSION_1_3;
 
     // Get required extensions
-    auto extensions = getRequiredExtensions(window);
+    auto extensions = getRequiredExtensions();
 
     // Instance create info
     VkInstanceCreateInfo createInfo{};
@@ -159,7 +251,7 @@ bool VulkanContext::createSurface(Window& window) {
     return true;
 }
 
-bool VulkanContext::pickPhysicalDevice() {
+bool VulkanContext::enumeratePhysicalDevices() {
     uint32_t deviceCount = 0;
     vkEnumeratePhysicalDevices(m_instance, &deviceCount, nullptr);
 
@@ -168,20 +260,32 @@ bool VulkanContext::pickPhysicalDevice() {
         return false;
     }
 
-    std::vector<VkPhysicalDevice> devices(deviceCount);
-    vkEnumeratePhysicalDevices(m_instance, &deviceCount, devices.data());
+    m_physicalDevices.resize(deviceCount);
+    vkEnumeratePhysicalDevices(m_instance, &deviceCount, m_physicalDevices.data());
+    m_physicalDevices.resize(deviceCount);
+    return true;
+}
 
-    std::cout << "Found " << deviceCount << " GPU(s):\n";
+bool VulkanContext::pickPhysicalDevice(const std::string& preferredDevice) {
+    std::cout << "Found " << m_physicalDevices.size() << " GPU(s):\n";
 
-    // Find a suitable device
-    for (const auto& device : devices) {
+    // Find a suitable device, preferring the requested one
+    std::string selectedName;
+    for (const auto& device : m_physicalDevices) {
         VkPhysicalDeviceProperties properties;
         vkGetPhysicalDeviceProperties(device, &properties);
         std::cout << "  - " << properties.deviceName << "\n";
 
-        if (isDeviceSuitable(device)) {
+        if (!isDeviceSuitable(device)) {
+            continue;
+        }
+
+        const bool preferred = !preferredDevice.empty() && strstr(properties.deviceName, preferredDevice.c_str());
+        if (m_physicalDevice == VK_NULL_HANDLE || preferred) {
             m_physicalDevice = device;
-            std::cout << "Selected GPU: " << properties.deviceName << "\n";
+            selectedName = properties.deviceName;
+        }
+        if (preferred || preferredDevice.empty()) {
             break;
         }
     }
@@ -191,6 +295,10 @@ bool VulkanContext::pickPhysicalDevice() {
         return false;
     }
 
+    if (!preferredDevice.empty() && selectedName.find(preferredDevice) == std::string::npos) {
+        std::cerr << "Warning: No suitable GPU matches '" << preferredDevice << "'\n";
+    }
+    std::cout << "Selected GPU: " << selectedName << "\n";
     return true;
 }
 
@@ -203,6 +311,9 @@ bool VulkanContext::createLogicalDevice() {
         m_queueFamilyIndices.graphicsFamily.value(),
         m_queueFamilyIndices.presentFamily.value()
     };
+    if (m_queueFamilyIndices.computeFamily.has_value()) {
+        uniqueQueueFamilies.insert(m_queueFamilyIndices.computeFamily.value());
+    }
 
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -217,14 +328,51 @@ bool VulkanContext::createLogicalDevice() {
     // Device features (enable as needed)
     VkPhysicalDeviceFeatures deviceFeatures{};
 
+    // Without a surface there is nothing to present to
+    std::vector<const char*> extensions = m_headless ? std::vector<const char*>{} : m_deviceExtensions;
+
+    // The render graph records synchronization2 barriers and orders queues with timeline semaphores
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.timelineSemaphore = VK_TRUE;
+    VkPhysicalDeviceVulkan13Features vulkan13Features{};
+    vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    vulkan13Features.synchronization2 = VK_TRUE;
+    vulkan12Features.pNext = &vulkan13Features;
+
+    // Present wait lets the frame pacer block until a frame is on screen instead of guessing
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+    if (!m_headless && hasDeviceExtension(m_physicalDevice, VK_KHR_PRESENT_ID_EXTENSION_NAME)
+        && hasDeviceExtension(m_physicalDevice, VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+        presentIdFeatures.pNext = &presentWaitFeatures;
+
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &presentIdFeatures;
+        vkGetPhysicalDeviceFeatures2(m_physicalDevice, &features2);
+
+        m_presentWaitEnabled = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+    }
+
+    if (m_presentWaitEnabled) {
+        extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    }
+
     // Create logical device
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    vulkan13Features.pNext = m_presentWaitEnabled ? &presentIdFeatures : nullptr;
+    createInfo.pNext = &vulkan12Features;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.pEnabledFeatures = &deviceFeatures;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(m_deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = m_deviceExtensions.data();
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
 
     // Validation layers (for compatibility with older Vulkan implementations)
     if (m_validationEnabled) {
@@ -243,11 +391,63 @@ bool VulkanContext::createLogicalDevice() {
     // Get queue handles
     vkGetDeviceQueue(m_device, m_queueFamilyIndices.graphicsFamily.value(), 0, &m_graphicsQueue);
     vkGetDeviceQueue(m_device, m_queueFamilyIndices.presentFamily.value(), 0, &m_presentQueue);
+    if (m_queueFamilyIndices.computeFamily.has_value()) {
+        vkGetDeviceQueue(m_device, m_queueFamilyIndices.computeFamily.value(), 0, &m_computeQueue);
+    }
+
+    std::cout << "Logical device created" << (m_computeQueue != VK_NULL_HANDLE ? " (async compute queue)" : "")
+              << (m_presentWaitEnabled ? " (present wait enabled)" : "") << ".\n";
+    return true;
+}
+
+bool VulkanContext::createPipelineCache(const std::vector<uint8_t>& initialData) {
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
 
-    std::cout << "Logical device created.\n";
+    // Drivers should reject a foreign cache, but not all do; only hand over our own
+    if (initialData.size() >= sizeof(VkPipelineCacheHeaderVersionOne)) {
+        VkPipelineCacheHeaderVersionOne header;
+        std::memcpy(&header, initialData.data(), sizeof(header));
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+
+        if (header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE && header.vendorID == properties.vendorID
+            && header.deviceID == properties.deviceID
+            && std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0) {
+            createInfo.initialDataSize = initialData.size();
+            createInfo.pInitialData = initialData.data();
+        } else {
+            std::cout << "Pipeline cache is from another driver or GPU; starting empty.\n";
+        }
+    }
+
+    VkResult result = vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_pipelineCache);
+    if (result != VK_SUCCESS) {
+        std::cerr << "Failed to create pipeline cache! Error: " << result << "\n";
+        return false;
+    }
+
+    if (createInfo.initialDataSize > 0) {
+        std::cout << "Pipeline cache loaded (" << createInfo.initialDataSize << " bytes).\n";
+    }
     return true;
 }
 
+void VulkanContext::savePipelineCache() const {
+    size_t size = 0;
+    if (vkGetPipelineCacheData(m_device, m_pipelineCache, &size, nullptr) != VK_SUCCESS) {
+        std::cerr << "Failed to query pipeline cache size\n";
+        return;
+    }
+
+    std::vector<uint8_t> data(size);
+    if (vkGetPipelineCacheData(m_device, m_pipelineCache, &size, data.data()) != VK_SUCCESS
+        || !writeFileAtomic(m_pipelineCachePath, data.data(), size)) {
+        std::cerr << "Failed to save pipeline cache: " << m_pipelineCachePath << "\n";
+    }
+}
+
 QueueFamilyIndices VulkanContext::findQueueFamilies(VkPhysicalDevice device) {
     QueueFamilyIndices indices;
 
@@ -263,9 +463,13 @@ QueueFamilyIndices VulkanContext::findQueueFamilies(VkPhysicalDevice device) {
             indices.graphicsFamily = i;
         }
 
-        // Check for present support
+        // Check for present support (headless contexts "present" on the graphics queue)
         VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
+        if (m_headless) {
+            presentSupport = (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) ? VK_TRUE : VK_FALSE;
+        } else {
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
+        }
         if (presentSupport) {
             indices.presentFamily = i;
         }
@@ -275,6 +479,14 @@ QueueFamilyIndices VulkanContext::findQueueFamilies(VkPhysicalDevice device) {
         }
     }
 
+    // A compute-only family runs alongside graphics instead of time-slicing with it
+    for (uint32_t i = 0; i < queueFamilyCount; i++) {
+        if ((queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT) && !(queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+            indices.computeFamily = i;
+            break;
+        }
+    }
+
     return indices;
 }
 
@@ -292,12 +504,51 @@ bool VulkanContext::isDeviceSuitable(VkPhysicalDevice device) {
     std::vector<VkExtensionProperties> availableExtensions(extensionCount);
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
 
-    std::set<std::string> requiredExtensions(m_deviceExtensions.begin(), m_deviceExtensions.end());
+    std::set<std::string> requiredExtensions;
+    if (!m_headless) {
+        requiredExtensions.insert(m_deviceExtensions.begin(), m_deviceExtensions.end());
+    }
     for (const auto& extension : availableExtensions) {
         requiredExtensions.erase(extension.extensionName);
     }
 
-    return requiredExtensions.empty();
+    if (!requiredExtensions.empty()) {
+        return false;
+    }
+
+    // Check Vulkan 1.3 with the synchronization features the render graph relies on
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+    if (properties.apiVersion < VK_API_VERSION_1_3) {
+        return false;
+    }
+
+    VkPhysicalDeviceVulkan13Features vulkan13Features{};
+    vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.pNext = &vulkan13Features;
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &vulkan12Features;
+    vkGetPhysicalDeviceFeatures2(device, &features2);
+
+    return vulkan12Features.timelineSemaphore && vulkan13Features.synchronization2;
+}
+
+bool VulkanContext::hasDeviceExtension(VkPhysicalDevice device, const char* name) {
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, extensions.data());
+
+    for (const auto& extension : extensions) {
+        if (strcmp(extension.extensionName, name) == 0) {
+            return true;
+        }
+    }
+    return false;
 }
 
 bool VulkanContext::checkValidationLayerSupport() {
@@ -325,11 +576,14 @@ bool VulkanContext::checkValidationLayerSupport() {
     return true;
 }
 
-std::vector<const char*> VulkanContext::getRequiredExtensions(Window& window) {
-    uint32_t glfwExtensionCount = 0;
-    const char** glfwExtensions = Window::getRequiredInstanceExtensions(&glfwExtensionCount);
+std::vector<const char*> VulkanContext::getRequiredExtensions() {
+    std::vector<const char*> extensions;
 
-    std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    if (!m_headless) {
+        uint32_t glfwExtensionCount = 0;
+        const char** glfwExtensions = Window::getRequiredInstanceExtensions(&glfwExtensionCount);
+        extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    }
 
     if (m_validationEnabled) {
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
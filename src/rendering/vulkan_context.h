@@ -2,6 +2,8 @@
 
 #include <vulkan/vulkan.h>
 
+#include <cstdint>
+#include <filesystem>
 #include <string>
 #include <vector>
 #include <optional>
@@ -16,12 +18,15 @@ struct VulkanContextConfig {
     std::string applicationName = "Cellular Threshold";
     uint32_t applicationVersion = VK_MAKE_VERSION(0, 1, 0);
     bool enableValidation = true;
+    std::string preferredDevice;    // Substring of the GPU name to pick when suitable (e.g. "llvmpipe")
+    std::filesystem::path pipelineCachePath;    // Loaded at startup, saved at shutdown (empty = in memory only)
 };
 
 /// Queue family indices for different queue types
 struct QueueFamilyIndices {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
+    std::optional<uint32_t> computeFamily;  // Compute without graphics (async compute), if the device has one
 
     [[nodiscard]] bool isComplete() const {
         return graphicsFamily.has_value() && presentFamily.has_value();
@@ -45,9 +50,34 @@ public:
     /// @return true if initialization succeeded
     bool initialize(const VulkanContextConfig& config, Window& window);
 
-    /// Shutdown and release all Vulkan resources
+    /// First half of initialize(): create the instance and enumerate GPUs
+    /// Needs the window system initialized (Window::initializePlatform) but not the window, so it
+    /// can run on another thread while the window is created.
+    /// @param config Vulkan configuration settings
+    /// @return true if initialization succeeded
+    bool initializeInstance(const VulkanContextConfig& config);
+
+    /// Second half of initialize(): create the surface, pick a GPU, create the device and pipeline cache
+    /// @param config Vulkan configuration settings (same as given to initializeInstance)
+    /// @param window Reference to the window for surface creation
+    /// @param pipelineCacheData Saved pipeline cache contents (see readPipelineCache)
+    /// @return true if initialization succeeded
+    bool initializeDevice(const VulkanContextConfig& config, Window& window,
+                          const std::vector<uint8_t>& pipelineCacheData = {});
+
+    /// Initialize Vulkan without a window, surface or swapchain (benchmarks, offline rendering)
+    /// @param config Vulkan configuration settings
+    /// @return true if initialization succeeded
+    bool initializeHeadless(const VulkanContextConfig& config);
+
+    /// Shutdown and release all Vulkan resources, saving the pipeline cache if it has a path
     void shutdown();
 
+    /// Read a pipeline cache file written by shutdown() (safe to call from any thread)
+    /// @param path Cache file; a missing file is not an error
+    /// @return File contents, or empty if there is none
+    static std::vector<uint8_t> readPipelineCache(const std::filesystem::path& path);
+
     /// Wait for the device to be idle (useful before cleanup)
     void waitIdle();
 
@@ -58,11 +88,22 @@ public:
     [[nodiscard]] VkSurfaceKHR getSurface() const { return m_surface; }
     [[nodiscard]] VkQueue getGraphicsQueue() const { return m_graphicsQueue; }
     [[nodiscard]] VkQueue getPresentQueue() const { return m_presentQueue; }
+    [[nodiscard]] VkQueue getComputeQueue() const { return m_computeQueue; }
+    [[nodiscard]] VkPipelineCache getPipelineCache() const { return m_pipelineCache; }
     [[nodiscard]] const QueueFamilyIndices& getQueueFamilyIndices() const { return m_queueFamilyIndices; }
 
+    /// Check whether a dedicated compute queue is available for async compute
+    [[nodiscard]] bool hasAsyncCompute() const { return m_computeQueue != VK_NULL_HANDLE; }
+
+    /// Check whether VK_KHR_present_id and VK_KHR_present_wait were enabled on the device
+    [[nodiscard]] bool isPresentWaitEnabled() const { return m_presentWaitEnabled; }
+
+    /// Query the present modes the surface supports
+    [[nodiscard]] std::vector<VkPresentModeKHR> getSurfacePresentModes() const;
+
 private:
     /// Create the Vulkan instance
-    bool createInstance(const VulkanContextConfig& config, Window& window);
+    bool createInstance(const VulkanContextConfig& config);
 
     /// Set up the debug messenger for validation layers
     bool setupDebugMessenger();
@@ -70,23 +111,35 @@ private:
     /// Create the window surface
     bool createSurface(Window& window);
 
+    /// List the physical devices (GPUs) of the instance
+    bool enumeratePhysicalDevices();
+
     /// Select a suitable physical device (GPU)
-    bool pickPhysicalDevice();
+    bool pickPhysicalDevice(const std::string& preferredDevice);
 
     /// Create the logical device and queues
     bool createLogicalDevice();
 
+    /// Create the pipeline cache, seeded with saved data when it was written by this driver and GPU
+    bool createPipelineCache(const std::vector<uint8_t>& initialData);
+
+    /// Write the pipeline cache to m_pipelineCachePath
+    void savePipelineCache() const;
+
     /// Find queue families that support required operations
     QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
 
     /// Check if a physical device is suitable for our needs
     bool isDeviceSuitable(VkPhysicalDevice device);
 
+    /// Check whether a device exposes an extension
+    static bool hasDeviceExtension(VkPhysicalDevice device, const char* name);
+
     /// Check if validation layers are available
     bool checkValidationLayerSupport();
 
     /// Get required device extensions
-    std::vector<const char*> getRequiredExtensions(Window& window);
+    std::vector<const char*> getRequiredExtensions();
 
     /// Debug callback for validation layer messages
     static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
@@ -122,9 +175,15 @@ private:
     VkDevice m_device = VK_NULL_HANDLE;
     VkQueue m_graphicsQueue = VK_NULL_HANDLE;
     VkQueue m_presentQueue = VK_NULL_HANDLE;
+    VkQueue m_computeQueue = VK_NULL_HANDLE;
+    VkPipelineCache m_pipelineCache = VK_NULL_HANDLE;
 
+    std::vector<VkPhysicalDevice> m_physicalDevices;
+    std::filesystem::path m_pipelineCachePath;
     QueueFamilyIndices m_queueFamilyIndices;
     bool m_validationEnabled = false;
+    bool m_presentWaitEnabled = false;
+    bool m_headless = false;
 
     // Validation layer names
     const std::vector<const char*> m_validationLayers = {
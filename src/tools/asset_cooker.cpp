@@ -0,0 +1,29 @@
+#include "asset_pipeline/asset_database.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+int main(int argc, char** argv) {
+    ct::AssetDatabaseConfig config;
+    if (argc > 1) {
+        config.sourceRoot = argv[1];
+    }
+    if (argc > 2) {
+        config.cookedRoot = argv[2];
+    }
+
+    ct::AssetDatabase database;
+    if (!database.initialize(config)) {
+        std::cerr << "Failed to initialize asset database!\n";
+        return EXIT_FAILURE;
+    }
+
+    // Specialized importers register ahead of the raw fallback as they come online
+    database.registerImporter(std::make_unique<ct::RawCopyImporter>());
+
+    ct::AssetBuildStats stats;
+    const bool success = database.build(&stats);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,185 @@
+#include "rendering/multiplex_image/tile_streamer.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Replays a recorded pan/zoom trace against the tile streamer and reports how long
+// visible tiles took to arrive.
+//
+// Usage: TileStreamReplay [trace.txt] [decodeMicroseconds]
+//
+// Trace format: one "time centerX centerY zoom" line per camera sample, in seconds and
+// level-0 pixels. Without a trace a scripted session is generated and written to
+// tile_trace.txt so the exact run can be replayed.
+
+namespace {
+
+constexpr uint32_t kImageSize = 30000;
+constexpr uint32_t kTileSize = 256;
+constexpr uint32_t kViewportWidth = 1280;
+constexpr uint32_t kViewportHeight = 720;
+constexpr double kFrameSeconds = 1.0 / 60.0;
+
+/// Stands in for a compressed TIFF: fills a pattern and burns a fixed decode cost per tile
+class SyntheticTileDecoder : public ct::TileDecoder {
+public:
+    explicit SyntheticTileDecoder(std::chrono::microseconds decodeCost) : m_decodeCost(decodeCost) {
+        uint32_t width = kImageSize;
+        uint32_t height = kImageSize;
+        for (;;) {
+            m_levels.push_back({width, height, (width + kTileSize - 1) / kTileSize, (height + kTileSize - 1) / kTileSize});
+            if (width <= kTileSize && height <= kTileSize) {
+                break;
+            }
+            width = (width + 1) / 2;
+            height = (height + 1) / 2;
+        }
+    }
+
+    [[nodiscard]] uint32_t getTileSize() const override { return kTileSize; }
+    [[nodiscard]] uint32_t getLevelCount() const override { return static_cast<uint32_t>(m_levels.size()); }
+    [[nodiscard]] ct::PyramidLevel getLevel(uint32_t level) const override { return m_levels[level]; }
+
+    bool decodeTile(const ct::TileKey& key, uint16_t* destination) override {
+        const auto deadline = std::chrono::steady_clock::now() + m_decodeCost;
+        const auto seed = static_cast<uint16_t>(key.x * 31 + key.y * 17 + key.level * 7 + key.channel);
+        for (uint32_t i = 0; i < kTileSize * kTileSize; i++) {
+            destination[i] = static_cast<uint16_t>(seed + i);
+        }
+        while (std::chrono::steady_clock::now() < deadline) {
+            // Busy wait: decoding is CPU-bound
+        }
+        return true;
+    }
+
+private:
+    std::chrono::microseconds m_decodeCost;
+    std::vector<ct::PyramidLevel> m_levels;
+};
+
+/// Scripted session: overview, zoom in, fast pans, zoom out
+std::vector<ct::TileViewState> generateTrace() {
+    std::vector<ct::TileViewState> trace;
+    const double center = kImageSize / 2.0;
+
+    for (double t = 0.0; t < 10.0; t += kFrameSeconds) {
+        ct::TileViewState view;
+        view.time = t;
+        view.viewportWidth = kViewportWidth;
+        view.viewportHeight = kViewportHeight;
+
+        if (t < 2.0) {
+            // Zoom from overview to 1:1
+            view.centerX = center;
+            view.centerY = center;
+            view.zoom = 0.04 * std::pow(25.0, t / 2.0);
+        } else if (t < 5.0) {
+            // Fast horizontal pan at 1:1
+            view.centerX = center + (t - 2.0) * 3000.0;
+            view.centerY = center;
+            view.zoom = 1.0;
+        } else if (t < 8.0) {
+            // Diagonal pan at 1:2
+            view.centerX = center + 9000.0 - (t - 5.0) * 4000.0;
+            view.centerY = center + (t - 5.0) * 3000.0;
+            view.zoom = 0.5;
+        } else {
+            // Zoom back out
+            view.centerX = center - 3000.0;
+            view.centerY = center + 9000.0;
+            view.zoom = 0.5 * std::pow(0.1, (t - 8.0) / 2.0);
+        }
+
+        trace.push_back(view);
+    }
+
+    return trace;
+}
+
+bool loadTrace(const std::string& path, std::vector<ct::TileViewState>& trace) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    ct::TileViewState view;
+    view.viewportWidth = kViewportWidth;
+    view.viewportHeight = kViewportHeight;
+    while (file >> view.time >> view.centerX >> view.centerY >> view.zoom) {
+        trace.push_back(view);
+    }
+    return !trace.empty();
+}
+
+void saveTrace(const std::string& path, const std::vector<ct::TileViewState>& trace) {
+    std::ofstream file(path);
+    file << std::setprecision(9);
+    for (const auto& view : trace) {
+        file << view.time << ' ' << view.centerX << ' ' << view.centerY << ' ' << view.zoom << '\n';
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<ct::TileViewState> trace;
+    if (argc > 1) {
+        if (!loadTrace(argv[1], trace)) {
+            std::cerr << "Failed to load trace: " << argv[1] << "\n";
+            return EXIT_FAILURE;
+        }
+    } else {
+        trace = generateTrace();
+        saveTrace("tile_trace.txt", trace);
+        std::cout << "Generated trace written to tile_trace.txt\n";
+    }
+
+    const auto decodeCost = std::chrono::microseconds(argc > 2 ? std::atoi(argv[2]) : 2000);
+    SyntheticTileDecoder decoder(decodeCost);
+
+    ct::TileStreamerConfig config;
+    config.channels = {0, 1, 2};
+    ct::TileStreamer streamer;
+    if (!streamer.initialize(decoder, config)) {
+        return EXIT_FAILURE;
+    }
+
+    // Replay in real time so decode workers see the same pressure a user would create
+    std::vector<ct::ReadyTile> ready;
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& view : trace) {
+        std::this_thread::sleep_until(start + std::chrono::duration<double>(view.time));
+
+        streamer.updateView(view);
+
+        ready.clear();
+        streamer.collectReady(ready);
+        for (const auto& tile : ready) {
+            streamer.releaseTile(tile);  // Upload would be recorded here
+        }
+    }
+
+    streamer.shutdown();
+
+    const ct::TileStreamStats stats = streamer.getStats();
+    std::cout << std::fixed << std::setprecision(2)
+              << "Replayed " << trace.size() << " frames\n"
+              << "  Decoded:        " << stats.decoded << " tiles\n"
+              << "  Cancelled:      " << stats.cancelled << " requests\n"
+              << "  Prefetch hits:  " << stats.prefetchHits << " tiles\n"
+              << "  Visible tiles:  " << stats.visibleLatency.count << " (" << stats.visibleUndelivered
+              << " not delivered while visible)\n"
+              << "  Visible-tile latency (ms): p50 " << stats.visibleLatency.percentile(0.50)
+              << ", p90 " << stats.visibleLatency.percentile(0.90)
+              << ", p99 " << stats.visibleLatency.percentile(0.99)
+              << ", max " << stats.visibleLatency.maxMs << "\n";
+
+    return EXIT_SUCCESS;
+}
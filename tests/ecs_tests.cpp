@@ -0,0 +1,57 @@
+#include "ecs/entity_manager.h"
+
+#include <iostream>
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool condition, const char* what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << "\n";
+        g_failures++;
+    }
+}
+
+struct Health {
+    int value = 0;
+};
+
+void testStaleHandleAdd() {
+    ct::EntityManager entities;
+    const ct::Entity stale = entities.create();
+    check(entities.addComponent<Health>(stale, {10}) != nullptr, "add to a live entity");
+    entities.destroy(stale);
+
+    const ct::Entity live = entities.create();
+    check(live.getIndex() == stale.getIndex(), "destroyed slot is reused");
+    check(entities.addComponent<Health>(live, {20}) != nullptr, "add to the new entity");
+
+    check(entities.addComponent<Health>(stale, {30}) == nullptr, "add through a stale handle is rejected");
+    const Health* health = entities.getComponent<Health>(live);
+    check(health && health->value == 20, "new entity keeps its component");
+    check(entities.getComponent<Health>(stale) == nullptr, "stale handle finds no component");
+}
+
+void testAddToDestroyedEntity() {
+    ct::EntityManager entities;
+    const ct::Entity entity = entities.create();
+    entities.destroy(entity);
+
+    check(entities.addComponent<Health>(entity, {5}) == nullptr, "add to a destroyed entity is rejected");
+    check(entities.getPool<Health>().size() == 0, "no component left on a destroyed entity");
+}
+
+} // namespace
+
+int main() {
+    testStaleHandleAdd();
+    testAddToDestroyedEntity();
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " ECS check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ECS tests passed\n";
+    return 0;
+}